@@ -1,9 +1,11 @@
 #include <signal.h>
 
 #include <iostream>
+#include <memory>
 #include <spot/twaalgos/sccfilter.hh>
 #include <vector>
 
+#include "bdd_utils.h"
 #include "find_deps_by_automaton.h"
 #include "find_deps_by_formula.h"
 #include "synt_instance.h"
@@ -56,6 +58,12 @@ int main(int argc, const char* argv[]) {
     verbose_out << synt_instance << endl;
     verbose_out << "================================" << endl;
 
+    // The prime variables must be reserved before the automaton is translated
+    std::unique_ptr<InterleavedPrimeVars> interleaved_prime_vars;
+    if (options.interleave_prime_vars) {
+        interleaved_prime_vars.reset(new InterleavedPrimeVars(gi.dict, synt_instance));
+    }
+
     signal(SIGINT, on_sighup);
     signal(SIGTERM, on_sighup);
     signal(SIGHUP, on_sighup);
@@ -85,7 +93,8 @@ int main(int argc, const char* argv[]) {
                         << formula_dependent_variables << endl;
             verbose_out << "Formula Dependency Variables: "
                         << formula_independent_variables << endl;
-        } else if (options.algorithm == Algorithm::AUTOMATON) {
+        } else if (options.algorithm == Algorithm::AUTOMATON ||
+                   options.algorithm == Algorithm::SAT) {
             auto* automaton_measures =
                 new AutomatonFindDepsMeasure(synt_instance, false);
             synt_measures = automaton_measures;
@@ -95,7 +104,7 @@ int main(int argc, const char* argv[]) {
 
             // Building Instance Automaton
             spot::twa_graph_ptr automaton = get_nba_for_synthesis(
-                    synt_instance.get_formula_parsed(), gi, *automaton_measures, verbose_out);
+                    synt_instance, gi, *automaton_measures, verbose_out, options.nba_cache_dir);
 
             // Search for dependent variables
             vector<string> automaton_dependent_variables,
@@ -111,8 +120,12 @@ int main(int argc, const char* argv[]) {
                 automaton_dependencies.set_dependent_variable_type(
                     FindDepsByAutomaton::DependentVariableType::Output);
             }
-            automaton_dependencies.find_dependencies(
-                automaton_dependent_variables, automaton_independent_variables, false);
+            automaton_dependencies.set_pair_states_workers(options.pair_states_workers);
+            automaton_dependencies.set_pair_states_engine(options.pair_states_engine);
+            automaton_dependencies.set_dependency_workers(options.dependency_workers);
+            automaton_dependencies.set_use_sat_solver(options.algorithm == Algorithm::SAT);
+            automaton_dependencies.find_dependencies(automaton_dependent_variables,
+                                                     automaton_independent_variables);
 
             verbose_out << "Automaton Dependent Variables: "
                         << automaton_dependent_variables << endl;
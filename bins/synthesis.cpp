@@ -8,11 +8,18 @@
 #include <future>
 #include <chrono>
 #include <thread>
+#include <fstream>
+#include <sstream>
 
 
+#include "BLIF.h"
+#include "batch_runner.h"
+#include "bdd_utils.h"
 #include "dependents_synthesiser.h"
 #include "find_deps_by_automaton.h"
+#include "forked_task.h"
 #include "merge_strategies.h"
+#include "portfolio_runner.h"
 #include "handle_unates_by_complement.h"
 #include "handle_unates_by_heuristic.h"
 #include "nba_utils.h"
@@ -29,11 +36,121 @@ static SynthesisCLIOptions options;
 
 void on_sighup(int args);
 
+static int synthesize_specification();
+
+static int synthesize_batch();
+
+static int synthesize_portfolio();
+
 int main(int argc, const char* argv[]) {
     int parsed_cli_status = parse_synthesis_cli(argc, argv, options);
     if (!parsed_cli_status) {
         return EXIT_FAILURE;
     }
+
+    if (!options.batch_path.empty()) {
+        return synthesize_batch();
+    }
+    if (options.portfolio) {
+        return synthesize_portfolio();
+    }
+    return synthesize_specification();
+}
+
+static int synthesize_batch() {
+    vector<BatchSpec> specs;
+    try {
+        read_batch_specs(options.batch_path, specs);
+    } catch (const std::runtime_error& re) {
+        std::cerr << "Runtime error: " << re.what() << std::endl;
+        return EXIT_FAILURE;
+    }
+
+    // BuDDy and ABC are initialized once, the process of each specification inherits them
+    spot::bdd_dict_ptr batch_dict = spot::make_bdd_dict();
+    AbcSession_ptr abc_session = AbcSession::get();
+
+    BatchRunner batch_runner(options.spec_timeout, options.spec_memory_limit);
+    unsigned total_failures = batch_runner.run(
+        specs,
+        [](const BatchSpec& spec) {
+            options.model_name = spec.name;
+            options.formula = spec.formula;
+            options.inputs = spec.inputs;
+            options.outputs = spec.outputs;
+            return options.portfolio ? synthesize_portfolio() : synthesize_specification();
+        },
+        options);
+
+    if (total_failures > 0) {
+        std::cerr << total_failures << " of " << specs.size()
+                  << " specifications failed or ran out of their budget" << std::endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+static int synthesize_portfolio() {
+    // With dependencies (if their search isn't skipped), then the whole game by each algo
+    vector<PortfolioConfig> configs;
+    auto add_config = [&](const string& name, bool find_deps,
+                          spot::synthesis_info::algo algo) {
+        configs.push_back({name, [find_deps, algo]() {
+                               options.portfolio = false;
+                               options.measures_path = "";
+                               options.synthesis_algo = algo;
+                               if (!find_deps) {
+                                   options.dependency_timeout = 0;
+                               }
+                               return synthesize_specification();
+                           }});
+    };
+    if (options.dependency_timeout > 0) {
+        add_config("deps-" + synthesis_algo_to_string(options.synthesis_algo), true,
+                   options.synthesis_algo);
+    }
+    add_config("nodeps-sd", false, spot::synthesis_info::algo::SPLIT_DET);
+    add_config("nodeps-ds", false, spot::synthesis_info::algo::DET_SPLIT);
+    add_config("nodeps-lar", false, spot::synthesis_info::algo::LAR);
+    add_config("nodeps-acd", false, spot::synthesis_info::algo::ACD);
+
+    PortfolioRunner portfolio_runner;
+    PortfolioResult result = portfolio_runner.run(configs);
+
+    json measures = result.measures;
+    if (result.winner >= 0) {
+        cout << result.output;
+    } else {
+        cout << "UNKNOWN (No configuration completed)" << endl;
+        measures = {{"model_name", options.model_name}, {"is_completed", false}};
+    }
+
+    json portfolio_obj, configurations_obj = json::array();
+    for (size_t i = 0; i < configs.size(); i++) {
+        configurations_obj.push_back({{"name", configs[i].name},
+                                      {"status", result.status[i]}});
+    }
+    portfolio_obj["winner"] = result.winner >= 0 ? json(configs[result.winner].name) : json();
+    portfolio_obj["configurations"] = configurations_obj;
+    portfolio_obj["duration"] = result.duration;
+    measures["portfolio"] = portfolio_obj;
+
+    if (options.measures_path.empty()) {
+        cout << measures << endl;
+        return EXIT_SUCCESS;
+    }
+    ofstream measure_file(options.measures_path,
+                          options.append_measures ? ios::app : ios::trunc);
+    if (measure_file.is_open()) {
+        measure_file << measures << endl;
+        cout << "Measures written to file: " << options.measures_path << endl;
+    } else {
+        cerr << "Failed to open fail: " << options.measures_path << endl;
+        cout << measures << endl;
+    }
+    return EXIT_SUCCESS;
+}
+
+static int synthesize_specification() {
     ostream nullout(nullptr);
     ostream& verbose = options.verbose ? std::cout : nullout;
 
@@ -42,16 +159,24 @@ int main(int argc, const char* argv[]) {
 
     // Prepare synthesis info
     spot::synthesis_info gi;
-    gi.s = spot::synthesis_info::algo::SPLIT_DET;
+    gi.s = options.synthesis_algo;
     gi.minimize_lvl = 2;  // i.e, simplication level
     SyntInstance synt_instance(options.inputs, options.outputs, options.formula);
     vector<string> input_vars(synt_instance.get_input_vars());
 
+    // The prime variables must be reserved before the automaton is translated
+    std::unique_ptr<InterleavedPrimeVars> interleaved_prime_vars;
+    if (options.interleave_prime_vars) {
+        interleaved_prime_vars.reset(new InterleavedPrimeVars(gi.dict, synt_instance));
+    }
+
     bool skip_dependencies = options.dependency_timeout <= 0;
     g_synt_measure =
         new SynthesisMeasure(synt_instance, skip_dependencies, options.skip_unates);
     SynthesisMeasure& synt_measure = *g_synt_measure;
     synt_measure.set_measure_bdd(options.measure_bdd);
+    synt_measure.set_model_name(options.model_name);
+    synt_measure.set_synthesis_algo(synthesis_algo_to_string(options.synthesis_algo));
 
     signal(SIGINT, on_sighup);
     signal(SIGTERM, on_sighup);
@@ -69,7 +194,7 @@ int main(int argc, const char* argv[]) {
     try {
         // Get NBA for synthesis
         spot::twa_graph_ptr nba = get_nba_for_synthesis(
-            synt_instance.get_formula_parsed(), gi, synt_measure, verbose);
+            synt_instance, gi, synt_measure, verbose, options.nba_cache_dir);
 
         // Handle Unate
         if(options.skip_unates) {
@@ -91,7 +216,7 @@ int main(int argc, const char* argv[]) {
 
         // Handle Dependent variables
         vector<string> dependent_variables, independent_variables;
-        twa_graph_ptr nba_without_deps = nullptr, nba_with_deps = nullptr;
+        twa_graph_ptr nba_without_deps = nullptr;
 
         if (skip_dependencies) {
             verbose << "=> Skipping finding and ejecting dependencies" << endl;
@@ -99,10 +224,14 @@ int main(int argc, const char* argv[]) {
         } else {
             FindDepsByAutomaton automaton_dependencies(synt_instance, synt_measure,
                                                        nba, false);
+            automaton_dependencies.set_pair_states_workers(options.pair_states_workers);
+            automaton_dependencies.set_pair_states_engine(options.pair_states_engine);
+            automaton_dependencies.set_dependency_workers(options.dependency_workers);
+            automaton_dependencies.set_use_sat_solver(options.sat_dependencies);
 
             std::future<void> fut = std::async(std::launch::async, [&] {
                 automaton_dependencies.find_dependencies(dependent_variables,
-                                                         independent_variables, false);
+                                                         independent_variables);
             });
             if (fut.wait_for(std::chrono::milliseconds (options.dependency_timeout)) == std::future_status::timeout) {
                 automaton_dependencies.stop();
@@ -115,23 +244,60 @@ int main(int argc, const char* argv[]) {
                     << " dependent variables" << endl;
         }
 
+        // The edges of the NBA keep their original conditions, for the dependents
         bool found_dependencies = !dependent_variables.empty();
-        bool should_clone_nba_with_deps = found_dependencies;
-        unordered_map<int, bdd> bdd_to_bdd_without_deps;
-
-        if (should_clone_nba_with_deps) {
-            synt_measure.start_clone_nba_with_deps();
-            nba_with_deps = clone_nba(nba);
-            synt_measure.end_clone_nba_with_deps();
-        }
-
         if (found_dependencies) {
             synt_measure.start_remove_dependent_ap();
-            remove_ap_from_automaton(nba, dependent_variables, bdd_to_bdd_without_deps);
+            remove_ap_from_automaton(nba, dependent_variables);
             synt_measure.end_remove_dependent_ap(nba);
         }
         nba_without_deps = nba;
 
+        string deps_state_encoding;
+        vector<AigerDescription> deps_encodings;
+        auto synthesize_dependents = [&]() {
+            DependentsSynthesiser dependents_synt(nba_without_deps, input_vars,
+                                                  independent_variables, dependent_variables,
+                                                  get_original_conditions(nba_without_deps));
+            dependents_synt.set_state_encoding(options.state_encoding);
+            spot::aig_ptr strategy = dependents_synt.synthesis();
+            deps_state_encoding = state_encoding_to_string(dependents_synt.get_state_encoding());
+            deps_encodings = dependents_synt.get_encodings();
+            return strategy;
+        };
+
+        // The dependents synthesis only needs the NBAs, so it may run in a forked process
+        // while the game of the independent variables is solved. It sends back its
+        // strategy in AIGER format (empty if it's unrealizable), its encodings and its
+        // duration, as JSON.
+        std::unique_ptr<ForkedTask> dependents_task;
+        if(options.fork_dependents_synthesis && !dependent_variables.empty()) {
+            dependents_task.reset(new ForkedTask([&]() {
+                TimeMeasure dependents_time;
+                dependents_time.start();
+                spot::aig_ptr strategy = synthesize_dependents();
+                Duration duration = dependents_time.end();
+                std::ostringstream aiger;
+                if (strategy != nullptr) {
+                    spot::print_aiger(aiger, strategy);
+                }
+
+                json result, encodings_obj = json::array();
+                for (auto& encoding : deps_encodings) {
+                    encodings_obj.push_back({{"state_encoding", encoding.state_encoding},
+                                             {"inputs", encoding.inputs},
+                                             {"outputs", encoding.outputs},
+                                             {"latches", encoding.latches},
+                                             {"gates", encoding.gates}});
+                }
+                result["aiger"] = aiger.str();
+                result["state_encoding"] = deps_state_encoding;
+                result["encodings"] = encodings_obj;
+                result["duration"] = duration;
+                return result.dump();
+            }));
+        }
+
         // Synthesis the independent variables
         spot::aig_ptr indeps_strategy = nullptr;
         if(!independent_variables.empty()) {
@@ -145,6 +311,9 @@ int main(int argc, const char* argv[]) {
 
         // Check Realizability of independent variables
         if(!independent_variables.empty() && indeps_strategy == nullptr) {
+            if (dependents_task != nullptr) {
+                dependents_task->cancel();
+            }
             cout << "UNREALIZABLE" << endl;
             synt_measure.completed();
 
@@ -155,13 +324,35 @@ int main(int argc, const char* argv[]) {
 
         // Synthesis the dependents variables
         spot::aig_ptr deps_strategy = nullptr;
-        if(!dependent_variables.empty()) {
+        if(dependents_task != nullptr) {
+            string deps_result;
+            synt_measure.start_waiting_dependents_synthesis();
+            if (!dependents_task->wait(deps_result)) {
+                throw std::runtime_error("The dependents synthesis process failed");
+            }
+            synt_measure.end_waiting_dependents_synthesis();
+            json result = json::parse(deps_result);
+            string deps_aiger = result["aiger"];
+            if (!deps_aiger.empty()) {
+                deps_strategy = spot::aig::parse_aag(deps_aiger.c_str(), "dependents_strategy", gi.dict);
+            }
+            deps_state_encoding = result["state_encoding"];
+            for (auto& encoding_obj : result["encodings"]) {
+                AigerDescription encoding;
+                encoding.state_encoding = encoding_obj["state_encoding"];
+                encoding.inputs = encoding_obj["inputs"];
+                encoding.outputs = encoding_obj["outputs"];
+                encoding.latches = encoding_obj["latches"];
+                encoding.gates = encoding_obj["gates"];
+                deps_encodings.push_back(encoding);
+            }
+            synt_measure.end_forked_dependents_synthesis(deps_strategy, deps_state_encoding,
+                                                         deps_encodings, result["duration"]);
+        } else if(!dependent_variables.empty()) {
             synt_measure.start_dependents_synthesis();
-            DependentsSynthesiser dependents_synt(nba_without_deps, nba_with_deps,
-                                                  input_vars, independent_variables,
-                                                  dependent_variables, bdd_to_bdd_without_deps);
-            deps_strategy = dependents_synt.synthesis();
-            synt_measure.end_dependents_synthesis(deps_strategy);
+            deps_strategy = synthesize_dependents();
+            synt_measure.end_dependents_synthesis(deps_strategy, deps_state_encoding,
+                                                  deps_encodings);
         }
 
         // Check Realizability of dependent variables
@@ -180,10 +371,21 @@ int main(int argc, const char* argv[]) {
             synt_measure.start_merge_strategies();
             final_strategy = merge_strategies(
                     indeps_strategy, deps_strategy, input_vars,
-                    independent_variables, dependent_variables, gi.dict, options.model_name);
+                    independent_variables, dependent_variables, gi.dict);
             synt_measure.end_merge_strategies(final_strategy);
         }
 
+        // Optimize the merged strategy by ABC
+        if(final_strategy != nullptr && options.abc_script != ABC_SKIP_SCRIPT) {
+            synt_measure.start_abc_optimization(options.abc_script);
+            vector<AbcPass> abc_passes;
+            BLIF final_blif(options.model_name);
+            final_blif.load_aig(final_strategy);
+            final_strategy = final_blif.to_aig(gi.dict, options.abc_script,
+                                               options.abc_time_budget, abc_passes);
+            synt_measure.end_abc_optimization(final_strategy, abc_passes);
+        }
+
         // Print the strategy
         if(final_strategy != nullptr) {
             spot::print_aiger(std::cout, final_strategy) << '\n';
@@ -235,6 +437,7 @@ int main(int argc, const char* argv[]) {
                   << std::endl;
         dump_measures(*g_synt_measure, options);
     }
+    return EXIT_SUCCESS;
 }
 
 void on_sighup(int args) {
@@ -2,160 +2,327 @@
 
 #include <boost/range/join.hpp>
 #include <cmath>
+#include <memory>
 #include <spot/twaalgos/sccfilter.hh>
 #include <string>
 
+#include "fork_workers_pool.h"
+#include "parallel_pair_states.h"
+#include "sat_dependency_checker.h"
+#include "symbolic_pair_states.h"
 #include "utils.h"
+#include "visited_pairs.h"
 
 using namespace std;
 
 void FindDepsByAutomaton::find_dependencies(vector<string>& dependent_variables,
-                                            vector<string>& independent_variables,
-                                            bool use_single_bdd) {
+                                            vector<string>& independent_variables) {
     m_measures.start_find_deps();
+    m_measures.set_prime_vars_layout(m_bdd_cacher->is_interleaved() ? "interleaved"
+                                                                     : "block");
 
     // Find Dependencies
-    std::vector<std::string> candidates;
+    std::vector<VarId> candidates, independents;
     this->find_dependencies_candidates(candidates);
+    for (auto& var : independent_variables) {
+        independents.push_back(m_synt_instance.get_var_id(var));
+    }
+
+    m_compact_nba.reset(new CompactNBA(m_automaton));
 
     // Find PairStates
     m_measures.start_search_pair_states();
     vector<PairState> compatibleStates;
-    get_all_compatible_states(compatibleStates, m_automaton);
-    m_measures.end_search_pair_states(static_cast<int>(compatibleStates.size()));
+    std::unique_ptr<SymbolicPairStates> symbolicStates;
+    bool use_symbolic_engine = !m_use_sat_solver && should_use_symbolic_engine();
+
+    if (use_symbolic_engine) {
+        m_measures.set_pair_states_engine("symbolic");
+        symbolicStates.reset(new SymbolicPairStates(m_automaton, m_stop_flag));
+        symbolicStates->compute();
+        m_measures.set_symbolic_pair_states_bdd_size(symbolicStates->get_bdd_size());
+        m_measures.end_search_pair_states(
+            static_cast<int>(symbolicStates->count_pair_states()));
+    } else {
+        m_measures.set_pair_states_engine("explicit");
+        if (m_pair_states_workers > 1) {
+            get_all_compatible_states_parallel(compatibleStates, m_automaton);
+        } else {
+            get_all_compatible_states(compatibleStates, m_automaton);
+        }
+        m_measures.end_search_pair_states(static_cast<int>(compatibleStates.size()));
+    }
+
+    m_total_conflict_pair_states = 0;
 
     if(m_stop_flag.load()) {
         // Add to independent variables all the candidates
-        independent_variables.insert(independent_variables.end(), candidates.begin(),
-                                     candidates.end());
+        for (VarId var : candidates) {
+            independent_variables.push_back(m_synt_instance.get_var_name(var));
+        }
         m_measures.end_find_deps(false);
         m_is_done.store(true);
         return;
     }
 
+    std::unique_ptr<SatDependencyChecker> satChecker;
+    if (m_use_sat_solver) {
+        m_measures.set_dependency_check_backend("sat");
+        satChecker.reset(new SatDependencyChecker(*m_compact_nba, compatibleStates));
+    }
+    long start_produced_nodes = get_bdd_produced_nodes();
+
+    auto check_variable = [&](VarId dependent_var, const VarSet& dependency_set) {
+        if (use_symbolic_engine) {
+            return is_variable_dependent(dependent_var, dependency_set, *symbolicStates);
+        } else if (m_use_sat_solver) {
+            return is_variable_dependent(dependent_var, dependency_set, *satChecker);
+        } else {
+            return is_variable_dependent(dependent_var, dependency_set, compatibleStates);
+        }
+    };
+
+    /**
+     * The greedy loop is order sensitive: a dependent variable is removed from the
+     * dependency sets of the next candidates. So the workers speculate that no
+     * candidate is dependent, and check each candidate against all the other variables.
+     * A variable which is not dependent on this maximal set is not dependent on any
+     * subset of it, so only the "dependent" verdicts may have to be checked again.
+     */
+    vector<int8_t> speculative_verdicts;
+    if (m_dependency_workers > 1 && candidates.size() > 1) {
+        m_measures.set_dependency_workers(m_dependency_workers);
+
+        ForkWorkersPool workers_pool(m_dependency_workers, m_stop_flag);
+        workers_pool.run(
+            candidates.size(),
+            [&](size_t candidate_idx) {
+                VarSet dependency_set;
+                this->extract_dependency_set(dependency_set, candidates, independents);
+                dependency_set.erase(candidates[candidate_idx]);
+                return check_variable(candidates[candidate_idx], dependency_set);
+            },
+            speculative_verdicts);
+    }
+    bool found_dependent = false;
+
     while (!candidates.empty() && !m_stop_flag.load()) {
-        std::string dependent_var = candidates.back();
+        VarId dependent_var = candidates.back();
+        std::string dependent_var_name = m_synt_instance.get_var_name(dependent_var);
         candidates.pop_back();
-        m_measures.start_testing_variable(dependent_var);
+        m_measures.start_testing_variable(dependent_var_name);
 
-        vector<string> dependency_set;
-        this->extract_dependency_set(dependency_set, candidates,
-                                     independent_variables);
+        VarSet dependency_set;
+        this->extract_dependency_set(dependency_set, candidates, independents);
 
         // Check if candidates variable is dependent
-        if (FindDepsByAutomaton::is_variable_dependent(dependent_var, dependency_set,
-                                                       compatibleStates, use_single_bdd)) {
-            dependent_variables.push_back(dependent_var);
-            m_measures.end_testing_variable(true, dependency_set);
+        int8_t speculative_verdict = speculative_verdicts.empty()
+                                         ? ForkWorkersPool::UNKNOWN_RESULT
+                                         : speculative_verdicts[candidates.size()];
+        bool is_dependent;
+        if (speculative_verdict == 0) {
+            is_dependent = false;
+        } else if (speculative_verdict == 1 && !found_dependent) {
+            is_dependent = true;
         } else {
-            independent_variables.push_back(dependent_var);
-            m_measures.end_testing_variable(false, dependency_set);
+            if (speculative_verdict == 1) {
+                m_measures.add_speculative_recheck();
+            }
+            is_dependent = check_variable(dependent_var, dependency_set);
+        }
+
+        vector<string> dependency_set_names;
+        m_synt_instance.get_var_names(dependency_set, dependency_set_names);
+        if (is_dependent) {
+            found_dependent = true;
+            dependent_variables.push_back(dependent_var_name);
+            m_measures.end_testing_variable(true, dependency_set_names);
+        } else {
+            independents.push_back(dependent_var);
+            independent_variables.push_back(dependent_var_name);
+            m_measures.end_testing_variable(false, dependency_set_names);
         }
     }
 
     // Add to independent variables all the candidates that left
-    independent_variables.insert(independent_variables.end(), candidates.begin(),
-                                 candidates.end());
+    for (VarId var : candidates) {
+        independent_variables.push_back(m_synt_instance.get_var_name(var));
+    }
+
+    if (satChecker != nullptr) {
+        m_measures.set_sat_calls(satChecker->get_total_sat_calls());
+    }
+    m_measures.set_dependency_check_bdd_nodes(get_bdd_produced_nodes() -
+                                              start_produced_nodes);
 
     m_measures.end_find_deps(!m_stop_flag.load());
     m_is_done.store(true);
 }
 
 void FindDepsByAutomaton::find_dependencies_candidates(
-    std::vector<std::string>& candidates_dst) {
-    candidates_dst.clear();
-
-    const vector<string>& candidates =
-        m_dependent_variable_type == DependentVariableType::Output
-            ? m_synt_instance.get_output_vars()
-            : m_synt_instance.get_input_vars();
-
-    std::copy(candidates.begin(), candidates.end(),
-              std::back_inserter(candidates_dst));
+    std::vector<VarId>& candidates_dst) {
+    candidates_dst = m_dependent_variable_type == DependentVariableType::Output
+                         ? m_synt_instance.get_output_ids()
+                         : m_synt_instance.get_input_ids();
 }
 
 void FindDepsByAutomaton::extract_dependency_set(
-    std::vector<std::string>& dependency_set_dst,
-    std::vector<std::string>& current_candidates,
-    std::vector<std::string>& current_independents) {
-    dependency_set_dst.clear();
+    VarSet& dependency_set_dst,
+    const std::vector<VarId>& current_candidates,
+    const std::vector<VarId>& current_independents) {
+    dependency_set_dst = VarSet(m_synt_instance.get_total_vars());
 
+    // Dependency Set = Input Vars (If searching output dependents) + Candidates Vars +
+    // Independent Vars
     if (m_dependent_variable_type == DependentVariableType::Output) {
-        // Dependency Set = Input Vars + Candidates Vars + Independent Vars
-        auto target_deps_set =
-            boost::join(m_synt_instance.get_input_vars(),
-                        boost::join(current_candidates, current_independents));
+        for (VarId var : m_input_ids) {
+            dependency_set_dst.insert(var);
+        }
+    }
+    for (VarId var : boost::join(current_candidates, current_independents)) {
+        dependency_set_dst.insert(var);
+    }
+}
 
-        copy(target_deps_set.begin(), target_deps_set.end(),
-             back_inserter(dependency_set_dst));
-    } else {
-        // Dependency Set = Candidates Vars + Independent Vars
-        auto target_deps_set = boost::join(current_candidates, current_independents);
-        copy(target_deps_set.begin(), target_deps_set.end(),
-             back_inserter(dependency_set_dst));
+bool FindDepsByAutomaton::should_use_symbolic_engine() const {
+    switch (m_pair_states_engine) {
+        case PairStatesEngine::SYMBOLIC_ENGINE:
+            return true;
+        case PairStatesEngine::EXPLICIT_ENGINE:
+            return false;
+        default:
+            return m_automaton->num_states() >= SYMBOLIC_PAIR_STATES_MIN_STATES;
     }
 }
 
-bool FindDepsByAutomaton::is_variable_dependent(std::string dependent_var,
-                                                vector<std::string>& dependency_vars,
-                                                vector<PairState>& pairStates,
-                                                bool use_single_bdd) {
-    // Extract variables indexes
-    vector<VarIndexer> reset_vars_nums;
-    vector<int> dependency_vars_nums;
-    int dependent_var_num = m_bdd_cacher->get_variable_index(dependent_var);
+void FindDepsByAutomaton::extract_variables_indexes(VarId dependent_var,
+                                                    const VarSet& dependency_vars,
+                                                    int& dependent_var_num,
+                                                    vector<int>& dependency_vars_nums,
+                                                    vector<VarIndexer>& reset_vars_nums) {
+    dependent_var_num = m_bdd_cacher->get_variable_index(dependent_var);
 
-    for (auto& var : dependency_vars) {
+    dependency_vars.for_each([&](VarId var) {
         dependency_vars_nums.push_back(m_bdd_cacher->get_variable_index(var));
-    }
-    vector<string> reset_vars;
-    vector<string> excluded_vars(dependency_vars);
-    excluded_vars.emplace_back(dependent_var);
-    m_synt_instance.all_vars_excluded(reset_vars, excluded_vars);
-    for (auto& var : reset_vars) {
+    });
+
+    // Reset Vars = All Vars - Dependency Vars - Dependent Var
+    VarSet reset_vars = dependency_vars.complement();
+    reset_vars.erase(dependent_var);
+    reset_vars.for_each([&](VarId var) {
         reset_vars_nums.push_back({m_bdd_cacher->get_variable_index(var),
                                    m_bdd_cacher->get_prime_variable_index(var)});
-    }
+    });
+}
 
-    if(use_single_bdd) {
-        /**
-         * For each pair-state (p,q), if:
-         * 1. Denote Edge[p] = Ep1, ..., Epn and Edge[q] = Eq1, ..., Eqn
-         * 2. Denote Corr[Epi] = Eqj if Dst[Epi] = Dst[Eqj], otherwise, None
-         * 3. Let z be the variable which we test if he's dependent
-         * 4. If the following formula is SAT then z is not dependent:
-         *  4.1 (Eq1 | ... | Eqn) & [ (Ep1[~z] & ~Corr[Ep1]) | ... | (Epn[~z] & ~Corr[Epn]) ]
-         *  4.2 If Corr[Ep1] is not exists, then define Corr[Ep1] to be the constant False
-         * 5. Corresponding check for (q, p) is required
-         */
-        for (auto pairState : pairStates) {
-            if(are_states_collides_by_edges(m_automaton, pairState.first, pairState.second, dependent_var_num)) {
-                return false;
-            }
-            if(are_states_collides_by_edges(m_automaton, pairState.second, pairState.first, dependent_var_num)) {
-                return false;
-            }
-        }
-        return true;
-    } else {
-        // For each pair-state, Can we move to an accepting state with different
-        // value of dependent_var? If yes, then dependent_var is not dependent
-        for (auto pairState : pairStates) {
-            for (auto& t1 : m_automaton->out(pairState.first)) {
-                for (auto& t2 : m_automaton->out(pairState.second)) {
-                    PairEdges pair_edges = PairEdges(t1, t2);
-
-                    if (!FindDepsByAutomaton::is_dependent_by_pair_edges(
-                            dependent_var_num, dependency_vars_nums, reset_vars_nums,
-                            pair_edges)) {
-                        return false;
-                    }
+bool FindDepsByAutomaton::is_variable_dependent(VarId dependent_var,
+                                                const VarSet& dependency_vars,
+                                                const SymbolicPairStates& pairStates) {
+    vector<VarIndexer> reset_vars_nums;
+    vector<int> dependency_vars_nums;
+    int dependent_var_num;
+    extract_variables_indexes(dependent_var, dependency_vars, dependent_var_num,
+                              dependency_vars_nums, reset_vars_nums);
+
+    return !pairStates.has_collision(dependent_var_num, reset_vars_nums);
+}
+
+bool FindDepsByAutomaton::is_variable_dependent(VarId dependent_var,
+                                                const VarSet& dependency_vars,
+                                                SatDependencyChecker& satChecker) {
+    int dependent_var_num = m_bdd_cacher->get_variable_index(dependent_var);
+    vector<int> dependency_vars_nums;
+    dependency_vars.for_each([&](VarId var) {
+        dependency_vars_nums.push_back(m_bdd_cacher->get_variable_index(var));
+    });
+
+    return !satChecker.has_collision(dependent_var_num, dependency_vars_nums);
+}
+
+bool FindDepsByAutomaton::is_variable_dependent(VarId dependent_var,
+                                                const VarSet& dependency_vars,
+                                                vector<PairState>& pairStates) {
+    // Extract variables indexes
+    vector<VarIndexer> reset_vars_nums;
+    vector<int> dependency_vars_nums;
+    int dependent_var_num;
+    extract_variables_indexes(dependent_var, dependency_vars, dependent_var_num,
+                              dependency_vars_nums, reset_vars_nums);
+
+    const CompactNBA& nba = *m_compact_nba;
+    RestrictionsCache restrictions(nba, dependent_var_num, reset_vars_nums);
+    bool is_dependent = true;
+
+    // For each pair-state, Can we move to an accepting state with different
+    // value of dependent_var? If yes, then dependent_var is not dependent
+    for (size_t i = 0; i < pairStates.size() && is_dependent; i++) {
+        PairState pairState = pairStates[i];
+        for (unsigned e1 = nba.edges_begin(pairState.first);
+             e1 < nba.edges_end(pairState.first) && is_dependent; e1++) {
+            for (unsigned e2 = nba.edges_begin(pairState.second);
+                 e2 < nba.edges_end(pairState.second); e2++) {
+                if (!FindDepsByAutomaton::is_dependent_by_pair_edges(
+                        restrictions, nba.edge_cond_id(e1), nba.edge_cond_id(e2))) {
+                    is_dependent = false;
+                    break;
                 }
             }
         }
+        if (!is_dependent) {
+            record_conflict_pair_state(pairStates, i);
+        }
+    }
 
-        return true;
+    m_measures.add_restrictions_cache_stats(restrictions.get_hits(),
+                                            restrictions.get_misses());
+    return is_dependent;
+}
+
+void FindDepsByAutomaton::record_conflict_pair_state(vector<PairState>& pairStates,
+                                                     size_t idx) {
+    if (idx < m_total_conflict_pair_states) {
+        m_measures.add_refuted_by_conflict_pair_state();
+        return;
     }
+
+    // Move the pair-state to the end of the conflicts prefix, the order of the rest
+    // of the pair-states is not important
+    std::swap(pairStates[idx], pairStates[m_total_conflict_pair_states]);
+    m_total_conflict_pair_states++;
+    m_measures.set_conflict_pair_states(m_total_conflict_pair_states);
+}
+
+RestrictionsCache::RestrictionsCache(const CompactNBA& nba, int dependent_var,
+                                     const vector<VarIndexer>& reset_vars)
+    : m_nba(nba),
+      m_dependent_var(dependent_var),
+      m_restrictions(nba.num_conds()),
+      m_is_cached(nba.num_conds(), false),
+      m_hits(0),
+      m_misses(0) {
+    m_prime_pairs = bdd_newpair();
+    for (auto& var : reset_vars) {
+        bdd_setpair(m_prime_pairs, var.var_index, var.prime_var_index);
+    }
+}
+
+const RestrictedCondition& RestrictionsCache::get(unsigned cond_id) {
+    RestrictedCondition& restriction = m_restrictions[cond_id];
+    if (m_is_cached[cond_id]) {
+        m_hits++;
+        return restriction;
+    }
+
+    m_misses++;
+    const bdd& cond = m_nba.cond(cond_id);
+    bdd prime_cond = bdd_replace(cond, m_prime_pairs);
+    restriction.positive = bdd_restrict(cond, bdd_ithvar(m_dependent_var));
+    restriction.negative = bdd_restrict(cond, bdd_nithvar(m_dependent_var));
+    restriction.prime_positive = bdd_restrict(prime_cond, bdd_ithvar(m_dependent_var));
+    restriction.prime_negative = bdd_restrict(prime_cond, bdd_nithvar(m_dependent_var));
+    m_is_cached[cond_id] = true;
+
+    return restriction;
 }
 
 /**
@@ -167,40 +334,23 @@ bool FindDepsByAutomaton::is_variable_dependent(std::string dependent_var,
  * and [∃Y : s1(Y, X=False, Z) & s2(Y, X=True, Z')] is not satisfiable as well.
  * Where Z are rest of variables.
  */
-bool FindDepsByAutomaton::is_dependent_by_pair_edges(int dependent_var,
-                                                     vector<int>& dependency_vars,
-                                                     vector<VarIndexer>& reset_vars,
-                                                     const PairEdges& edges) {
-    bdd z1(edges.first.cond);
-    bdd z2(edges.second.cond);
-
-    // Replace in z2 the reset_vars with their prime vars
-    bddPair* pairs = bdd_newpair();
-    for (auto& var : reset_vars) {
-        bdd_setpair(pairs, var.var_index, var.prime_var_index);
-    }
-    z2 = bdd_replace(z2, pairs);
+bool FindDepsByAutomaton::is_dependent_by_pair_edges(RestrictionsCache& restrictions,
+                                                     unsigned cond1_id,
+                                                     unsigned cond2_id) {
+    const RestrictedCondition& z1 = restrictions.get(cond1_id);
+    const RestrictedCondition& z2 = restrictions.get(cond2_id);
 
     // Case 1: s1(Y, X=True, Z) & s2(Y, X=False, Z') is unsat
-    bdd cond1 = bdd_restrict(z1, bdd_ithvar(dependent_var)) &
-                bdd_restrict(z2, bdd_nithvar(dependent_var));
-    bool cond1_sat = cond1 != bddfalse;
-    if (cond1_sat) {
-        bdd_freepair(pairs);
+    if (bdd_have_common_assignment(z1.positive, z2.prime_negative)) {
         return false;
     }
 
     // Case 2: s1(Y, X=False, Z) & s2(Y, X=True, Z') is unsat
-    bdd cond2 = bdd_restrict(z1, bdd_nithvar(dependent_var)) &
-                bdd_restrict(z2, bdd_ithvar(dependent_var));
-    bool cond2_sat = cond2 != bddfalse;
-    if (cond2_sat) {
-        bdd_freepair(pairs);
+    if (bdd_have_common_assignment(z1.negative, z2.prime_positive)) {
         return false;
     }
 
     // No condition is satified
-    bdd_freepair(pairs);
     return true;
 }
 
@@ -210,54 +360,70 @@ bool FindDepsByAutomaton::get_all_compatible_states(std::vector<PairState>& pair
                                const spot::twa_graph_ptr& aut) {
     unsigned init_state = aut->get_init_state_number();
     std::vector<PairState> queue = {PairState(init_state, init_state)}; // Everything in the queue is compatible
-    std::unordered_set<std::pair<int, int>, pair_hash> tested_pairs;
+    VisitedPairs tested_pairs(aut->num_states());
+    bool is_stopped = false;
 
-    while (!queue.empty() && !m_stop_flag.load()) {
+    while (!queue.empty() && !is_stopped && !m_stop_flag.load()) {
         PairState pairState = queue.back();
         queue.pop_back();
 
-        // Make sure the smaller state number comes first
-        if (pairState.first > pairState.second) {
-            std::swap(pairState.first, pairState.second);
-        }
-
         // Check if the pair was already tested
-        if (tested_pairs.find(pairState) != tested_pairs.end()) {
+        if (!tested_pairs.insert(pairState.first, pairState.second)) {
             continue;
         }
 
-        tested_pairs.insert(pairState);
+        // Make sure the smaller state number comes first
+        if (pairState.first > pairState.second) {
+            std::swap(pairState.first, pairState.second);
+        }
         pairStates.emplace_back(pairState.first, pairState.second);
 
-        for (auto& t1 : aut->out(pairState.first)) {
-            for (auto& t2 : aut->out(pairState.second)) {
+        const CompactNBA& nba = *m_compact_nba;
+        for (unsigned e1 = nba.edges_begin(pairState.first);
+             e1 < nba.edges_end(pairState.first) && !is_stopped; e1++) {
+            for (unsigned e2 = nba.edges_begin(pairState.second);
+                 e2 < nba.edges_end(pairState.second); e2++) {
                 if(m_stop_flag.load()) {
-                    return false;
+                    is_stopped = true;
+                    break;
                 }
 
-                PairState newState(t1.dst, t2.dst);
-
-                // Make sure the smaller state number comes first
-                if (newState.first > newState.second) {
-                    std::swap(newState.first, newState.second);
-                }
-                // Check if the pair was already tested before adding it to the queue 6
-                if (tested_pairs.find(newState) != tested_pairs.end()) {
+                // Check if the pair was already tested before adding it to the queue
+                unsigned dst1 = nba.edge_dst(e1), dst2 = nba.edge_dst(e2);
+                if (tested_pairs.contains(dst1, dst2)) {
                     continue;
                 }
 
-                if(t1.dst == t2.dst) {
-                    queue.emplace_back(newState);
-                } else if(are_edges_shares_assignment(t1, t2)) {
-                    queue.emplace_back(newState);
+                if(dst1 == dst2) {
+                    queue.emplace_back(dst1, dst2);
+                } else if(bdd_have_common_assignment(nba.edge_cond(e1), nba.edge_cond(e2))) {
+                    queue.emplace_back(dst1, dst2);
                 }
             }
         }
     }
 
+    m_measures.set_visited_pairs(visited_pairs_structure_to_string(tested_pairs.structure()),
+                                 tested_pairs.memory_usage());
     return queue.empty() && !m_stop_flag.load();
 }
 
+bool FindDepsByAutomaton::get_all_compatible_states_parallel(
+    std::vector<PairState>& pairStates, const spot::twa_graph_ptr& aut) {
+    ParallelPairStatesSearch search(aut, m_pair_states_workers, m_stop_flag);
+
+    if (!search.is_applicable()) {
+        m_measures.set_pair_states_workers(1);
+        return get_all_compatible_states(pairStates, aut);
+    }
+
+    m_measures.set_pair_states_workers(m_pair_states_workers);
+    bool is_completed = search.run(pairStates);
+    m_measures.set_visited_pairs(visited_pairs_structure_to_string(search.visited_structure()),
+                                 search.visited_memory_usage());
+    return is_completed;
+}
+
 // TODO: this is buggy to verify if variables are pair states, get back to it later (12/05/2023)
 // Are the variables used in the edges are the same?
 bool are_edges_shares_variable(spot::twa_graph::edge_storage_t& e1,
@@ -273,41 +439,3 @@ bool are_edges_shares_assignment(spot::twa_graph::edge_storage_t& e1,
                                spot::twa_graph::edge_storage_t& e2) {
     return (e1.cond & e2.cond) != bddfalse;
 }
-
-bool are_states_collides_by_edges(spot::twa_graph_ptr& automaton, unsigned state1, unsigned state2, int dependent_var_num) {
-    auto edges_p = automaton->out(state1);
-    auto edges_q = automaton->out(state2);
-
-    // state2's edges are tested
-    bdd q_edges_cond = bddfalse;
-    for(auto& edge : edges_q) {
-        q_edges_cond |= edge.cond;
-    }
-
-    // state1's edges are tested
-    bdd p_edges_cond = bddfalse;
-    for(auto& p_edge : edges_p) {
-        auto q_corr_edge = std::find_if(edges_q.begin(), edges_q.end(), [&](auto& e) {
-            return e.dst == p_edge.dst;
-        });
-        if(q_corr_edge == edges_q.end()) {
-            continue;
-        }
-
-        bddPair* pairs = bdd_newpair();
-        bdd_setbddpair(pairs, dependent_var_num, bdd_nithvar(dependent_var_num));
-        if(q_corr_edge != edges_q.end()) {
-            p_edges_cond |=
-                    bdd_replace( p_edge.cond, pairs )
-                    & bdd_not(q_corr_edge->cond);  // Epi[~z] & ~Corr[Epi]
-        } else {
-            p_edges_cond |= bdd_replace( p_edge.cond, pairs ); // Epi[~z] & ~False = Epi[~z]
-        }
-
-        bdd_freepair(pairs);
-    }
-
-    // Verify if collides
-    bool is_collides = (q_edges_cond & p_edges_cond) != bddfalse;
-    return is_collides;
-}
@@ -1,35 +1,82 @@
 #ifndef FIND_DEPS_BY_AUTOMATON_H
 #define FIND_DEPS_BY_AUTOMATON_H
 
+#include <algorithm>
 #include <map>
+#include <memory>
 #include <spot/tl/parse.hh>
 #include <spot/twaalgos/sccfilter.hh>
 #include <spot/twaalgos/translate.hh>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <atomic>
 
 #include "bdd_utils.h"
+#include "compact_nba.h"
 #include "synt_instance.h"
 #include "synt_measure.h"
+#include "utils.h"
+
+// In AUTO_ENGINE mode, automata with at least this number of states use the symbolic
+// pair-states engine
+#define SYMBOLIC_PAIR_STATES_MIN_STATES 4096
+
+class SymbolicPairStates;
+class SatDependencyChecker;
 
 using PairState = std::pair<unsigned, unsigned>;
 
-using PairEdges =
-    std::pair<spot::twa_graph::edge_storage_t, spot::twa_graph::edge_storage_t>;
 
 
 bool are_edges_shares_variable(spot::twa_graph::edge_storage_t& e1,
                                spot::twa_graph::edge_storage_t& e2);
 bool are_edges_shares_assignment(spot::twa_graph::edge_storage_t& e1,
                                  spot::twa_graph::edge_storage_t& e2);
-bool are_states_collides_by_edges(spot::twa_graph_ptr& automaton, unsigned state1, unsigned state2, int dependent_var_num);
 
 struct VarIndexer {
     int var_index{};
     int prime_var_index{};
 };
 
+struct RestrictedCondition {
+    bdd positive;        // cond[X=True, Z]
+    bdd negative;        // cond[X=False, Z]
+    bdd prime_positive;  // cond[X=True, Z']
+    bdd prime_negative;  // cond[X=False, Z']
+};
+
+/**
+ * @brief The restrictions of the edges' conditions by a single dependent variable X,
+ * cached by the condition's index in the CompactNBA. The same condition appears in
+ * many pair-states, so each restriction is computed once per tested variable.
+ */
+class RestrictionsCache {
+   private:
+    const CompactNBA& m_nba;
+    int m_dependent_var;
+    bddPair* m_prime_pairs;  // Z -> Z', built once per tested variable
+    std::vector<RestrictedCondition> m_restrictions;
+    std::vector<bool> m_is_cached;
+    long m_hits;
+    long m_misses;
+
+   public:
+    RestrictionsCache(const CompactNBA& nba, int dependent_var,
+                      const std::vector<VarIndexer>& reset_vars);
+
+    RestrictionsCache(const RestrictionsCache&) = delete;
+    RestrictionsCache& operator=(const RestrictionsCache&) = delete;
+
+    ~RestrictionsCache() { bdd_freepair(m_prime_pairs); }
+
+    const RestrictedCondition& get(unsigned cond_id);
+
+    long get_hits() const { return m_hits; }
+
+    long get_misses() const { return m_misses; }
+};
+
 class FindDepsByAutomaton {
    public:
     /**
@@ -42,34 +89,59 @@ class FindDepsByAutomaton {
     SyntInstance& m_synt_instance;
     AutomatonFindDepsMeasure& m_measures;
     spot::twa_graph_ptr m_automaton;
+    std::unique_ptr<CompactNBA> m_compact_nba;  // Built at the start of the search
     BDDVarsCacher* m_bdd_cacher;
+    std::vector<VarId> m_input_ids;
     DependentVariableType m_dependent_variable_type;
+    unsigned m_pair_states_workers;
+    PairStatesEngine m_pair_states_engine;
+    bool m_use_sat_solver;
+    unsigned m_dependency_workers;
+    size_t m_total_conflict_pair_states;  // Size of the conflicts prefix of the pair-states
     std::atomic<bool> m_stop_flag;
     std::atomic<bool> m_is_done;
 
 
-    bool is_variable_dependent(std::string dependent_var,
-                               std::vector<std::string>& dependency_vars,
-                               std::vector<PairState>& pairStates,
-                               bool use_single_bdd);
+    bool is_variable_dependent(VarId dependent_var, const VarSet& dependency_vars,
+                               std::vector<PairState>& pairStates);
+
+    bool is_variable_dependent(VarId dependent_var, const VarSet& dependency_vars,
+                               const SymbolicPairStates& pairStates);
+
+    bool is_variable_dependent(VarId dependent_var, const VarSet& dependency_vars,
+                               SatDependencyChecker& satChecker);
+
+    void extract_variables_indexes(VarId dependent_var,
+                                   const VarSet& dependency_vars,
+                                   int& dependent_var_num,
+                                   std::vector<int>& dependency_vars_nums,
+                                   std::vector<VarIndexer>& reset_vars_nums);
 
-    bool is_dependent_by_pair_edges(int dependent_var,
-                                    std::vector<int>& dependency_vars,
-                                    vector<VarIndexer>& reset_vars,
-                                    const PairEdges& edges);
+    bool should_use_symbolic_engine() const;
+
+    /**
+     * @brief The pair-state pairStates[idx] showed that a candidate is not dependent.
+     * Such pair-states are kept as a prefix of pairStates, so the next candidates are
+     * checked against them first (Independent variables are usually refuted by the
+     * same few pair-states).
+     */
+    void record_conflict_pair_state(std::vector<PairState>& pairStates, size_t idx);
+
+    bool is_dependent_by_pair_edges(RestrictionsCache& restrictions,
+                                    unsigned cond1_id, unsigned cond2_id);
 
     void init_automaton();
 
-    void find_dependencies_candidates(std::vector<std::string>& candidates_dst);
+    void find_dependencies_candidates(std::vector<VarId>& candidates_dst);
 
     /**
      * @brief In a validation of a dependent variables, we need to calculate what's
      * the dependency set of the dependent variable. This function extracts the
      * dependency set.
      */
-    void extract_dependency_set(std::vector<std::string>& dependency_set_dst,
-                                std::vector<std::string>& current_candidates,
-                                std::vector<std::string>& current_independents);
+    void extract_dependency_set(VarSet& dependency_set_dst,
+                                const std::vector<VarId>& current_candidates,
+                                const std::vector<VarId>& current_independents);
 
     /**
      * @brief Extract all the states in automaton which are reachable by the same prefix.
@@ -78,6 +150,13 @@ class FindDepsByAutomaton {
     bool get_all_compatible_states(std::vector<PairState>& pairStates,
                                    const spot::twa_graph_ptr& aut);
 
+    /**
+     * @brief Same as get_all_compatible_states, using m_pair_states_workers threads.
+     * Fallback to the single-threaded search if the automaton is too large for it.
+     */
+    bool get_all_compatible_states_parallel(std::vector<PairState>& pairStates,
+                                            const spot::twa_graph_ptr& aut);
+
    public:
     explicit FindDepsByAutomaton(SyntInstance& synt_instance,
                                  AutomatonFindDepsMeasure& measure,
@@ -86,7 +165,12 @@ class FindDepsByAutomaton {
           m_measures(measure),
           m_stop_flag(false),
           m_is_done(false),
-          m_dependent_variable_type(DependentVariableType::Output) {
+          m_dependent_variable_type(DependentVariableType::Output),
+          m_pair_states_workers(1),
+          m_pair_states_engine(PairStatesEngine::AUTO_ENGINE),
+          m_use_sat_solver(false),
+          m_dependency_workers(1),
+          m_total_conflict_pair_states(0) {
         m_automaton = aut;
 
         // TODO: remove should prune and making sure the caller is pruning by himself
@@ -96,7 +180,8 @@ class FindDepsByAutomaton {
             m_measures.end_prune_automaton(m_automaton);
         }
 
-        m_bdd_cacher = new BDDVarsCacher(m_automaton);
+        m_bdd_cacher = new BDDVarsCacher(m_automaton, m_synt_instance);
+        m_input_ids = m_synt_instance.get_input_ids();
     }
 
     ~FindDepsByAutomaton() {
@@ -109,9 +194,27 @@ class FindDepsByAutomaton {
         m_dependent_variable_type = type;
     }
 
+    void set_pair_states_workers(unsigned total_workers) {
+        m_pair_states_workers = std::max(1u, total_workers);
+    }
+
+    void set_pair_states_engine(PairStatesEngine engine) {
+        m_pair_states_engine = engine;
+    }
+
+    /**
+     * @brief Check the dependencies by a SAT solver instead of BDD operations,
+     * the pair-states are always searched explicitly in this case.
+     */
+    void set_use_sat_solver(bool use_sat_solver) { m_use_sat_solver = use_sat_solver; }
+
+    // Number of forked processes which check the candidates, see ForkWorkersPool
+    void set_dependency_workers(unsigned total_workers) {
+        m_dependency_workers = std::max(1u, total_workers);
+    }
+
     void find_dependencies(std::vector<std::string>& dependent_variables,
-                           std::vector<std::string>& independent_variables,
-                           bool use_single_bdd);
+                           std::vector<std::string>& independent_variables);
 
     void stop() {
         return m_stop_flag.store(true);
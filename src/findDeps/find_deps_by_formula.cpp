@@ -2,78 +2,106 @@
 
 #include <boost/algorithm/string/join.hpp>
 #include <boost/algorithm/string/replace.hpp>
+#include <boost/range/join.hpp>
 #include <spot/tl/formula.hh>
 #include <spot/tl/parse.hh>
+#include <spot/twa/twaproduct.hh>
 #include <spot/twaalgos/contains.hh>
 #include <spot/twaalgos/translate.hh>
 
 void FindDepsByFormula::find_dependencies(
     std::vector<std::string>& dependent_variables,
     std::vector<std::string>& independent_variables) {
-    std::vector<std::string> candidates(m_synt_instance.get_output_vars());
-    const std::vector<std::string>& input_vars = m_synt_instance.get_input_vars();
+    std::vector<VarId> candidates = m_synt_instance.get_output_ids();
+    const std::vector<VarId> input_ids = m_synt_instance.get_input_ids();
+    std::vector<VarId> independents;
+    for (auto& var : independent_variables) {
+        independents.push_back(m_synt_instance.get_var_id(var));
+    }
+
+    build_automata();
 
     while (!candidates.empty()) {
-        std::string dependent_var = candidates.back();
+        VarId dependent_var = candidates.back();
+        std::string dependent_var_name = m_synt_instance.get_var_name(dependent_var);
         candidates.pop_back();
 
-        m_measures.start_testing_variable(dependent_var);
+        m_measures.start_testing_variable(dependent_var_name);
 
         // Build dependency set: (Input + Candidates + Independents)
-        vector<string> dependency_set = input_vars;
-        std::copy(candidates.begin(), candidates.end(),
-                  std::back_inserter(dependency_set));
-        std::copy(independent_variables.begin(), independent_variables.end(),
-                  std::back_inserter(dependency_set));
+        VarSet dependency_set(m_synt_instance.get_total_vars());
+        for (VarId var : boost::range::join(input_ids,
+                                            boost::range::join(candidates, independents))) {
+            dependency_set.insert(var);
+        }
+        vector<string> dependency_set_names;
+        m_synt_instance.get_var_names(dependency_set, dependency_set_names);
 
         // Check if candidates variable is dependent
         if (this->is_variable_dependent(dependent_var, dependency_set)) {
-            dependent_variables.push_back(dependent_var);
-            m_measures.end_testing_variable(true, dependency_set);
+            dependent_variables.push_back(dependent_var_name);
+            m_measures.end_testing_variable(true, dependency_set_names);
         } else {
-            independent_variables.push_back(dependent_var);
-            m_measures.end_testing_variable(false, dependency_set);
+            independents.push_back(dependent_var);
+            independent_variables.push_back(dependent_var_name);
+            m_measures.end_testing_variable(false, dependency_set_names);
         }
     }
 }
 
-bool FindDepsByFormula::is_variable_dependent(string& dependent_var,
-                                              vector<string>& dependency_vars) {
-    spot::formula* dependency_formula =
-        get_dependency_formula(dependent_var, dependency_vars);
+void FindDepsByFormula::build_automata() {
+    // Register each variable next to its prime, so the BDD of (Y↔Y') is linear in |Y|
+    for (VarId var = 0; var < m_synt_instance.get_total_vars(); var++) {
+        const std::string& var_name = m_synt_instance.get_var_name(var);
+        m_var_nums.push_back(
+            m_dict->register_proposition(spot::formula::ap(var_name), this));
+        m_prime_var_nums.push_back(m_dict->register_proposition(
+            spot::formula::ap(get_prime_variable(var_name)), this));
+    }
 
+    // φ and φ' are translated once, and shared by all the tested variables
     spot::translator trans(m_dict);
-    spot::twa_graph_ptr automaton = trans.run(dependency_formula);
-    bool is_empty = automaton->is_empty();
-
-    delete dependency_formula;
-    return is_empty;
+    m_automaton = trans.run(m_synt_instance.get_formula_parsed());
+    m_prime_automaton = trans.run(m_prime_synt_instance->get_formula_parsed());
 }
 
-spot::formula* FindDepsByFormula::get_dependency_formula(
-    string& dependent_var, vector<string>& dependency_vars) {
-    if (dependent_var.empty() || dependency_vars.empty()) {
-        throw std::invalid_argument(
-            "Dependent and dependency are required to have at least 1 item to "
-            "check for dependency");
-    }
-
-    vector<string> dependent_vars = {dependent_var};
+bool FindDepsByFormula::is_variable_dependent(VarId dependent_var,
+                                              const VarSet& dependency_vars) {
+    spot::twa_graph_ptr monitor = build_dependency_monitor(dependent_var, dependency_vars);
 
-    spot::formula dependencies_equals_to_prime_formula, dependents_equals_to_prime_formula;
-    equal_to_primes_formula(dependencies_equals_to_prime_formula, dependency_vars);
-    equal_to_primes_formula(dependents_equals_to_prime_formula, dependent_vars);
+    // The language of φ ∧ φ' ∧ (¬(z↔z') M (Y↔Y')), the product is explored on-the-fly
+    // and the emptiness check stops at the first accepting run.
+    auto product = spot::otf_product(monitor, spot::otf_product(m_automaton, m_prime_automaton));
 
-    auto* dependency_formula = new spot::formula(
-            spot::formula::And( {
-                m_synt_instance.get_formula_parsed(),
-                m_prime_synt_instance->get_formula_parsed(),
-                spot::formula::M(
-                    spot::formula::Not(dependents_equals_to_prime_formula),
-                    dependencies_equals_to_prime_formula)
-            }));
+    return product->is_empty();
+}
 
-    return dependency_formula;
+spot::twa_graph_ptr FindDepsByFormula::build_dependency_monitor(
+    VarId dependent_var, const VarSet& dependency_vars) {
+    spot::twa_graph_ptr monitor = spot::make_twa_graph(m_dict);
+    m_dict->register_all_variables_of(this, monitor);
+
+    bdd dependencies_equals_to_prime = bddtrue;
+    dependency_vars.for_each([&](VarId var) {
+        dependencies_equals_to_prime &=
+            bdd_biimp(bdd_ithvar(m_var_nums[var]), bdd_ithvar(m_prime_var_nums[var]));
+    });
+    bdd dependent_equals_to_prime = bdd_biimp(bdd_ithvar(m_var_nums[dependent_var]),
+                                              bdd_ithvar(m_prime_var_nums[dependent_var]));
+
+    monitor->set_buchi();
+    monitor->prop_state_acc(true);
+    unsigned waiting = monitor->new_state();
+    unsigned differ = monitor->new_state();
+    monitor->set_init_state(waiting);
+
+    monitor->new_edge(waiting, waiting,
+                      dependencies_equals_to_prime & dependent_equals_to_prime);
+    monitor->new_edge(waiting, differ,
+                      dependencies_equals_to_prime & !dependent_equals_to_prime);
+    monitor->new_edge(differ, differ, bddtrue, {0});
+
+    return monitor;
 }
 
 spot::formula replace_ap_with_prime(spot::formula i) {
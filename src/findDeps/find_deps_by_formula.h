@@ -2,6 +2,7 @@
 #define FIND_DEPS_BY_FORMULA_H
 
 #include <spot/twa/twa.hh>
+#include <spot/twa/twagraph.hh>
 #include <string>
 #include <vector>
 
@@ -10,9 +11,6 @@
 
 using namespace std;
 
-// We make a prime variable by adding the suffix "_pp" to variable's name
-inline std::string get_prime_variable(const std::string &var) { return var + "_pp"; }
-
 spot::formula replace_ap_with_prime(spot::formula i);
 
 void equal_to_primes_formula(spot::formula &formula, vector<string> &vars);
@@ -23,15 +21,24 @@ class FindDepsByFormula {
     SyntInstance *m_prime_synt_instance;
     BaseDependentsMeasures &m_measures;
     spot::bdd_dict_ptr m_dict;
+    spot::twa_graph_ptr m_automaton;        // Automaton of φ
+    spot::twa_graph_ptr m_prime_automaton;  // Automaton of φ'
+    std::vector<int> m_var_nums;            // VarId -> BDD variable
+    std::vector<int> m_prime_var_nums;      // VarId -> BDD variable of its prime
 
-    bool is_variable_dependent(string &dependent_var,
-                               vector<string> &dependency_vars);
+    bool is_variable_dependent(VarId dependent_var, const VarSet &dependency_vars);
 
-    spot::formula *get_dependency_formula(string &dependent_var,
-                                          vector<string> &dependency_vars);
+    /**
+     * @brief Build the automaton of ¬(z↔z') M (Y↔Y'), it has only 2 states:
+     * waiting while Y↔Y' holds, and an accepting sink reached once z and z' differ.
+     */
+    spot::twa_graph_ptr build_dependency_monitor(VarId dependent_var,
+                                                 const VarSet &dependency_vars);
 
     void build_prime_synt_instance(bool use_string_manipulation = false);
 
+    void build_automata();
+
    public:
     explicit FindDepsByFormula(SyntInstance &synt_instance, BaseDependentsMeasures &measure)
         : m_synt_instance(synt_instance), m_measures(measure) {
@@ -39,7 +46,12 @@ class FindDepsByFormula {
         m_dict = spot::make_bdd_dict();
     }
 
-    ~FindDepsByFormula() { delete m_prime_synt_instance; }
+    ~FindDepsByFormula() {
+        m_automaton = nullptr;
+        m_prime_automaton = nullptr;
+        m_dict->unregister_all_my_variables(this);
+        delete m_prime_synt_instance;
+    }
 
     void find_dependencies(std::vector<std::string> &dependent_variables,
                            std::vector<std::string> &independent_variables);
@@ -0,0 +1,219 @@
+#include "parallel_pair_states.h"
+
+#include <algorithm>
+#include <thread>
+#include <unordered_map>
+
+using namespace std;
+
+static size_t shared_assignment_table_size(size_t total_conditions) {
+    return total_conditions * (total_conditions + 1) / 2;
+}
+
+static uint64_t pair_state_key(const PairState& pair_state) {
+    return (static_cast<uint64_t>(pair_state.first) << 32) | pair_state.second;
+}
+
+ParallelPairStatesSearch::ParallelPairStatesSearch(const spot::twa_graph_ptr& automaton,
+                                                   unsigned total_workers,
+                                                   std::atomic<bool>& stop_flag)
+    : m_automaton(automaton),
+      m_total_workers(std::max(1u, total_workers)),
+      m_stop_flag(stop_flag),
+      m_visited_structure(VisitedPairs::Structure::TriangularBitmap),
+      m_visited_bitmap_words(0),
+      m_pending(0) {
+    index_automaton();
+}
+
+void ParallelPairStatesSearch::index_automaton() {
+    unordered_map<int, unsigned> cond_to_index;
+    m_out_edges.resize(m_automaton->num_states());
+
+    for (unsigned state = 0; state < m_automaton->num_states(); state++) {
+        for (auto& edge : m_automaton->out(state)) {
+            auto cond_it = cond_to_index.find(edge.cond.id());
+            unsigned cond;
+            if (cond_it == cond_to_index.end()) {
+                cond = static_cast<unsigned>(m_conditions.size());
+                cond_to_index[edge.cond.id()] = cond;
+                m_conditions.push_back(edge.cond);
+            } else {
+                cond = cond_it->second;
+            }
+
+            m_out_edges[state].push_back({edge.dst, cond});
+        }
+    }
+}
+
+bool ParallelPairStatesSearch::is_applicable() const {
+    return shared_assignment_table_size(m_conditions.size()) <=
+           PARALLEL_PAIR_STATES_MAX_TABLE_SIZE;
+}
+
+bool ParallelPairStatesSearch::are_conditions_share_assignment(unsigned cond1,
+                                                                unsigned cond2) {
+    if (cond1 > cond2) {
+        std::swap(cond1, cond2);
+    }
+    std::atomic<uint8_t>& entry =
+        m_shared_assignment[static_cast<size_t>(cond2) * (cond2 + 1) / 2 + cond1];
+
+    uint8_t value = entry.load(std::memory_order_acquire);
+    if (value == SharedAssignment::Unknown) {
+        std::lock_guard<std::mutex> lock(m_bdd_mutex);
+
+        value = entry.load(std::memory_order_relaxed);
+        if (value == SharedAssignment::Unknown) {
+            bool is_shared = (m_conditions[cond1] & m_conditions[cond2]) != bddfalse;
+            value = is_shared ? SharedAssignment::Shared : SharedAssignment::Disjoint;
+            entry.store(value, std::memory_order_release);
+        }
+    }
+
+    return value == SharedAssignment::Shared;
+}
+
+bool ParallelPairStatesSearch::visit(PairState pair_state) {
+    if (m_visited_structure == VisitedPairs::Structure::TriangularBitmap) {
+        uint64_t idx = static_cast<uint64_t>(pair_state.second) * (pair_state.second + 1) / 2 +
+                       pair_state.first;
+        uint64_t bit = 1ull << (idx & 63);
+        return !(m_visited_bitmap[idx >> 6].fetch_or(bit) & bit);
+    }
+
+    uint64_t key = pair_state_key(pair_state);
+    // Fibonacci hashing, so neighbour pair-states are spread over the shards
+    size_t shard_idx = ((key * 0x9E3779B97F4A7C15ull) >> 32) %
+                       PARALLEL_PAIR_STATES_VISITED_SHARDS;
+    VisitedShard& shard = *m_visited_shards[shard_idx];
+
+    std::lock_guard<std::mutex> lock(shard.mutex);
+    return shard.pair_states.insert(pair_state.first, pair_state.second);
+}
+
+void ParallelPairStatesSearch::push(unsigned worker, PairState pair_state) {
+    m_pending.fetch_add(1);
+
+    Frontier& frontier = *m_frontiers[worker];
+    std::lock_guard<std::mutex> lock(frontier.mutex);
+    frontier.pair_states.push_back(pair_state);
+}
+
+bool ParallelPairStatesSearch::pop(unsigned worker, PairState& pair_state) {
+    // Own frontier is used as a stack (DFS order)
+    {
+        Frontier& frontier = *m_frontiers[worker];
+        std::lock_guard<std::mutex> lock(frontier.mutex);
+        if (!frontier.pair_states.empty()) {
+            pair_state = frontier.pair_states.back();
+            frontier.pair_states.pop_back();
+            return true;
+        }
+    }
+
+    // Steal the oldest pair-state of another worker
+    for (unsigned i = 1; i < m_total_workers; i++) {
+        Frontier& victim = *m_frontiers[(worker + i) % m_total_workers];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.pair_states.empty()) {
+            pair_state = victim.pair_states.front();
+            victim.pair_states.pop_front();
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void ParallelPairStatesSearch::work(unsigned worker,
+                                    std::vector<PairState>& pair_states_dst) {
+    PairState pair_state;
+
+    while (!m_stop_flag.load()) {
+        if (!pop(worker, pair_state)) {
+            if (m_pending.load() == 0) {
+                return;
+            }
+            std::this_thread::yield();
+            continue;
+        }
+
+        pair_states_dst.push_back(pair_state);
+
+        for (auto& e1 : m_out_edges[pair_state.first]) {
+            for (auto& e2 : m_out_edges[pair_state.second]) {
+                if (m_stop_flag.load()) {
+                    return;
+                }
+
+                PairState new_state(std::min(e1.dst, e2.dst), std::max(e1.dst, e2.dst));
+                bool is_compatible = e1.dst == e2.dst ||
+                                     are_conditions_share_assignment(e1.cond, e2.cond);
+
+                if (is_compatible && visit(new_state)) {
+                    push(worker, new_state);
+                }
+            }
+        }
+
+        m_pending.fetch_sub(1);
+    }
+}
+
+bool ParallelPairStatesSearch::run(std::vector<PairState>& pair_states) {
+    assert(is_applicable() && "Too many edge conditions for the parallel search");
+
+    m_shared_assignment.reset(
+        new std::atomic<uint8_t>[shared_assignment_table_size(m_conditions.size())]());
+    for (unsigned worker = 0; worker < m_total_workers; worker++) {
+        m_frontiers.emplace_back(new Frontier());
+    }
+
+    unsigned total_states = m_automaton->num_states();
+    uint64_t total_bits = static_cast<uint64_t>(total_states) * (total_states + 1) / 2;
+    if (total_bits <= VISITED_PAIRS_MAX_BITMAP_BITS) {
+        m_visited_structure = VisitedPairs::Structure::TriangularBitmap;
+        m_visited_bitmap_words = (total_bits + 63) / 64;
+        m_visited_bitmap.reset(new std::atomic<uint64_t>[m_visited_bitmap_words]());
+    } else {
+        m_visited_structure = VisitedPairs::Structure::HashTable;
+        for (unsigned shard = 0; shard < PARALLEL_PAIR_STATES_VISITED_SHARDS; shard++) {
+            m_visited_shards.emplace_back(new VisitedShard(total_states));
+        }
+    }
+
+    unsigned init_state = m_automaton->get_init_state_number();
+    PairState init_pair_state(init_state, init_state);
+    visit(init_pair_state);
+    push(0, init_pair_state);
+
+    // The calling thread is the first worker
+    vector<vector<PairState>> workers_pair_states(m_total_workers);
+    vector<std::thread> workers;
+    for (unsigned worker = 1; worker < m_total_workers; worker++) {
+        workers.emplace_back(&ParallelPairStatesSearch::work, this, worker,
+                             std::ref(workers_pair_states[worker]));
+    }
+    work(0, workers_pair_states[0]);
+
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    for (auto& worker_pair_states : workers_pair_states) {
+        pair_states.insert(pair_states.end(), worker_pair_states.begin(),
+                           worker_pair_states.end());
+    }
+
+    return !m_stop_flag.load();
+}
+
+size_t ParallelPairStatesSearch::visited_memory_usage() const {
+    size_t total_bytes = m_visited_bitmap_words * sizeof(uint64_t);
+    for (auto& shard : m_visited_shards) {
+        total_bytes += shard->pair_states.memory_usage();
+    }
+    return total_bytes;
+}
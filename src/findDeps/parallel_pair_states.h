@@ -0,0 +1,109 @@
+#ifndef PARALLEL_PAIR_STATES_H
+#define PARALLEL_PAIR_STATES_H
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <spot/twa/twagraph.hh>
+#include <vector>
+
+#include "find_deps_by_automaton.h"
+#include "visited_pairs.h"
+
+// Upper bound on the entries of the shared-assignment table (1 byte per entry)
+#define PARALLEL_PAIR_STATES_MAX_TABLE_SIZE (1u << 25)
+#define PARALLEL_PAIR_STATES_VISITED_SHARDS 64
+
+/**
+ * @brief Multi-threaded search of all the pair-states (p,q) which are reachable by
+ * the same prefix, the result is the same set as the single-threaded DFS in
+ * FindDepsByAutomaton::get_all_compatible_states, but in an arbitrary order.
+ *
+ * Each worker owns a frontier of pair-states and steals from the other workers when
+ * its own frontier is empty. The visited pair-states are stored in a triangular bitmap
+ * updated with atomic operations, or in a sharded hash set for large automata, so a
+ * pair-state is pushed to a frontier exactly once.
+ *
+ * BuDDy is not thread-safe, so the workers never touch a BDD: the edge conditions are
+ * indexed on the calling thread, and the only BDD operation of the search (does two
+ * conditions share an assignment) is computed under a lock and memoized in a table
+ * which is read without locking.
+ */
+class ParallelPairStatesSearch {
+   private:
+    struct OutEdge {
+        unsigned dst;
+        unsigned cond;
+    };
+
+    struct Frontier {
+        std::mutex mutex;
+        std::deque<PairState> pair_states;
+    };
+
+    struct VisitedShard {
+        std::mutex mutex;
+        VisitedPairs pair_states;
+
+        // Always a hash table, the bitmap is shared by all the workers
+        explicit VisitedShard(unsigned total_states) : pair_states(total_states, 0) {}
+    };
+
+    enum SharedAssignment : uint8_t { Unknown = 0, Shared = 1, Disjoint = 2 };
+
+    const spot::twa_graph_ptr& m_automaton;
+    unsigned m_total_workers;
+    std::atomic<bool>& m_stop_flag;
+
+    // Automaton snapshot, built on the calling thread
+    std::vector<std::vector<OutEdge>> m_out_edges;
+    std::vector<bdd> m_conditions;
+
+    // Lazy table of "conditions i and j share an assignment", indexed by (i,j), i<=j
+    std::unique_ptr<std::atomic<uint8_t>[]> m_shared_assignment;
+    std::mutex m_bdd_mutex;
+
+    std::vector<std::unique_ptr<Frontier>> m_frontiers;
+    VisitedPairs::Structure m_visited_structure;
+    std::unique_ptr<std::atomic<uint64_t>[]> m_visited_bitmap;
+    size_t m_visited_bitmap_words;
+    std::vector<std::unique_ptr<VisitedShard>> m_visited_shards;
+    std::atomic<long> m_pending;  // Pair-states which were pushed but not expanded
+
+    void index_automaton();
+
+    bool are_conditions_share_assignment(unsigned cond1, unsigned cond2);
+
+    // Mark the pair-state as visited, return false if it was already visited
+    bool visit(PairState pair_state);
+
+    void push(unsigned worker, PairState pair_state);
+
+    bool pop(unsigned worker, PairState& pair_state);
+
+    void work(unsigned worker, std::vector<PairState>& pair_states_dst);
+
+   public:
+    ParallelPairStatesSearch(const spot::twa_graph_ptr& automaton,
+                             unsigned total_workers, std::atomic<bool>& stop_flag);
+
+    /**
+     * @brief The table of shared assignments is quadratic in the number of distinct
+     * edge conditions, so the parallel search is limited to automata which fit it.
+     */
+    bool is_applicable() const;
+
+    /**
+     * @brief Return true if finished successfully and didn't stopped by the stop flag.
+     */
+    bool run(std::vector<PairState>& pair_states);
+
+    VisitedPairs::Structure visited_structure() const { return m_visited_structure; }
+
+    // Total bytes allocated by the visited pair-states
+    size_t visited_memory_usage() const;
+};
+
+#endif
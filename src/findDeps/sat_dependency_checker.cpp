@@ -0,0 +1,149 @@
+#include "sat_dependency_checker.h"
+
+using namespace std;
+
+static inline int neg_lit(int lit) { return lit ^ 1; }
+
+SatDependencyChecker::SatDependencyChecker(const CompactNBA& nba,
+                                           const vector<PairState>& pair_states)
+    : m_nba(nba), m_total_vars(0), m_total_sat_calls(0) {
+    m_solver = sat_solver_new();
+
+    m_true_lit = new_lit();
+    vector<int> true_clause = {m_true_lit};
+    add_clause(true_clause);
+
+    for (auto& out_lits : m_out_lits) {
+        out_lits.assign(m_nba.num_states(), -1);
+    }
+
+    encode_pair_states(pair_states);
+}
+
+int SatDependencyChecker::new_lit() {
+    int var = m_total_vars++;
+    sat_solver_setnvars(m_solver, m_total_vars);
+    return 2 * var;
+}
+
+void SatDependencyChecker::add_clause(vector<int>& clause) {
+    sat_solver_addclause(m_solver, clause.data(), clause.data() + clause.size());
+}
+
+int SatDependencyChecker::get_var_lit(int bdd_var, VarsCopy copy) {
+    auto lit_it = m_var_lits[copy].find(bdd_var);
+    if (lit_it != m_var_lits[copy].end()) {
+        return lit_it->second;
+    }
+
+    int lit = new_lit();
+    m_var_lits[copy][bdd_var] = lit;
+    return lit;
+}
+
+int SatDependencyChecker::get_equal_lit(int bdd_var) {
+    auto lit_it = m_equal_lits.find(bdd_var);
+    if (lit_it != m_equal_lits.end()) {
+        return lit_it->second;
+    }
+
+    int var = get_var_lit(bdd_var, VarsCopy::Current);
+    int prime_var = get_var_lit(bdd_var, VarsCopy::Prime);
+    int equal = new_lit();
+
+    // Eq -> (v <-> v')
+    vector<int> clause1 = {neg_lit(equal), neg_lit(var), prime_var};
+    vector<int> clause2 = {neg_lit(equal), var, neg_lit(prime_var)};
+    add_clause(clause1);
+    add_clause(clause2);
+
+    m_equal_lits[bdd_var] = equal;
+    return equal;
+}
+
+int SatDependencyChecker::encode_condition(const bdd& cond, VarsCopy copy) {
+    if (cond == bddtrue) {
+        return m_true_lit;
+    }
+    if (cond == bddfalse) {
+        return neg_lit(m_true_lit);
+    }
+
+    auto lit_it = m_node_lits[copy].find(cond.id());
+    if (lit_it != m_node_lits[copy].end()) {
+        return lit_it->second;
+    }
+
+    int var = get_var_lit(bdd_var(cond), copy);
+    int high = encode_condition(bdd_high(cond), copy);
+    int low = encode_condition(bdd_low(cond), copy);
+    int node = new_lit();
+
+    // The conditions are only required positively, so one direction is enough:
+    // Node -> ITE(var, high, low)
+    vector<int> clause1 = {neg_lit(node), neg_lit(var), high};
+    vector<int> clause2 = {neg_lit(node), var, low};
+    add_clause(clause1);
+    add_clause(clause2);
+
+    m_node_lits[copy][cond.id()] = node;
+    return node;
+}
+
+int SatDependencyChecker::encode_state_out(unsigned state, VarsCopy copy) {
+    if (m_out_lits[copy][state] != -1) {
+        return m_out_lits[copy][state];
+    }
+
+    int out = new_lit();
+    vector<int> clause = {neg_lit(out)};
+    for (unsigned edge = m_nba.edges_begin(state); edge < m_nba.edges_end(state); edge++) {
+        clause.push_back(encode_condition(m_nba.edge_cond(edge), copy));
+    }
+    add_clause(clause);
+
+    m_out_lits[copy][state] = out;
+    return out;
+}
+
+void SatDependencyChecker::encode_pair_states(const vector<PairState>& pair_states) {
+    m_active_lit = new_lit();
+    vector<int> active_clause = {neg_lit(m_active_lit)};
+
+    for (auto& pair_state : pair_states) {
+        // Both orders of the pair-state, (p,q) and (q,p)
+        for (int order = 0; order < 2; order++) {
+            unsigned p = order == 0 ? pair_state.first : pair_state.second;
+            unsigned q = order == 0 ? pair_state.second : pair_state.first;
+            if (order == 1 && p == q) {
+                break;
+            }
+
+            int selected = new_lit();
+            vector<int> clause1 = {neg_lit(selected), encode_state_out(p, VarsCopy::Current)};
+            vector<int> clause2 = {neg_lit(selected), encode_state_out(q, VarsCopy::Prime)};
+            add_clause(clause1);
+            add_clause(clause2);
+
+            active_clause.push_back(selected);
+        }
+    }
+
+    add_clause(active_clause);
+}
+
+bool SatDependencyChecker::has_collision(int dependent_var,
+                                         const vector<int>& dependency_vars) {
+    vector<int> assumptions = {m_active_lit,
+                               get_var_lit(dependent_var, VarsCopy::Current),
+                               neg_lit(get_var_lit(dependent_var, VarsCopy::Prime))};
+    for (int var : dependency_vars) {
+        assumptions.push_back(get_equal_lit(var));
+    }
+
+    m_total_sat_calls++;
+    int result = sat_solver_solve(m_solver, assumptions.data(),
+                                  assumptions.data() + assumptions.size(), 0, 0, 0, 0);
+
+    return result == ABC_SAT_TRUE;
+}
@@ -0,0 +1,75 @@
+#ifndef SAT_DEPENDENCY_CHECKER_H
+#define SAT_DEPENDENCY_CHECKER_H
+
+#include <spot/twa/twagraph.hh>
+#include <unordered_map>
+#include <vector>
+
+#include "abc_utils.h"
+#include "compact_nba.h"
+#include "find_deps_by_automaton.h"
+
+/**
+ * @brief Check dependencies over the pair-states by ABC's SAT solver, instead of BDD
+ * operations over each pair of edges.
+ *
+ * The CNF has two copies of the automaton's variables, V (for p) and V' (for q). The
+ * edges' conditions are encoded once (by Tseitin over their BDD nodes), and so does:
+ *      Out_p(V) -> OR of p's outgoing edges conditions
+ *      Active -> OR over the pair-states (p,q), (q,p) of [Out_p(V) & Out_q(V')]
+ *      Eq_v -> (v <-> v')
+ * A variable X is not dependent on Y iff the formula is satisfiable under the
+ * assumptions: Active, X, !X', and Eq_y for each y in Y. Since the clauses are never
+ * changed, a single incremental solver answers all the candidates, and the learned
+ * clauses are shared between them.
+ */
+class SatDependencyChecker {
+   private:
+    const CompactNBA& m_nba;
+    sat_solver* m_solver;
+    int m_total_vars;
+    int m_true_lit;
+    int m_active_lit;
+    long m_total_sat_calls;
+
+    enum VarsCopy { Current = 0, Prime = 1 };
+
+    std::unordered_map<int, int> m_var_lits[2];   // BDD variable -> literal
+    std::unordered_map<int, int> m_node_lits[2];  // BDD node -> literal
+    std::unordered_map<int, int> m_equal_lits;    // BDD variable -> Eq literal
+    std::vector<int> m_out_lits[2];               // State -> Out literal
+
+    int new_lit();
+
+    void add_clause(std::vector<int>& clause);
+
+    int get_var_lit(int bdd_var, VarsCopy copy);
+
+    int get_equal_lit(int bdd_var);
+
+    // Literal which implies the condition is satisfied
+    int encode_condition(const bdd& cond, VarsCopy copy);
+
+    int encode_state_out(unsigned state, VarsCopy copy);
+
+    void encode_pair_states(const std::vector<PairState>& pair_states);
+
+   public:
+    SatDependencyChecker(const CompactNBA& nba, const std::vector<PairState>& pair_states);
+
+    SatDependencyChecker(const SatDependencyChecker&) = delete;
+    SatDependencyChecker& operator=(const SatDependencyChecker&) = delete;
+
+    ~SatDependencyChecker() { sat_solver_delete(m_solver); }
+
+    /**
+     * @brief Is there a pair-state (p,q) such that:
+     *      Out(p)[X=True, Z] & Out(q)[X=False, Z'] is satisfiable
+     * Where Z are the variables which are neither X nor in the dependency vars.
+     */
+    bool has_collision(int dependent_var, const std::vector<int>& dependency_vars);
+
+    long get_total_sat_calls() const { return m_total_sat_calls; }
+};
+
+#endif
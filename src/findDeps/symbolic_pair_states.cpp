@@ -0,0 +1,184 @@
+#include "symbolic_pair_states.h"
+
+using namespace std;
+
+SymbolicPairStates::SymbolicPairStates(const spot::twa_graph_ptr& automaton,
+                                       std::atomic<bool>& stop_flag)
+    : m_automaton(automaton),
+      m_stop_flag(stop_flag),
+      m_state_bits(1),
+      m_pair_states(bddfalse) {
+    while ((1u << m_state_bits) < m_automaton->num_states()) {
+        m_state_bits++;
+    }
+
+    m_vars_start = m_automaton->get_dict()->register_anonymous_variables(
+        static_cast<int>(4 * m_state_bits), this);
+
+    m_p_cube = bddtrue;
+    m_q_cube = bddtrue;
+    m_ap_cube = m_automaton->ap_vars();
+    m_next_to_current = bdd_newpair();
+    for (unsigned bit = 0; bit < m_state_bits; bit++) {
+        m_p_cube &= bdd_ithvar(state_bit_var(StateCopy::P, bit));
+        m_q_cube &= bdd_ithvar(state_bit_var(StateCopy::Q, bit));
+        bdd_setpair(m_next_to_current, state_bit_var(StateCopy::NextP, bit),
+                    state_bit_var(StateCopy::P, bit));
+        bdd_setpair(m_next_to_current, state_bit_var(StateCopy::NextQ, bit),
+                    state_bit_var(StateCopy::Q, bit));
+    }
+
+    build_transitions();
+}
+
+SymbolicPairStates::~SymbolicPairStates() {
+    bdd_freepair(m_next_to_current);
+
+    // Release the BDDs before their variables are unregistered
+    m_p_delta = m_q_delta = bddfalse;
+    m_p_moves = m_q_moves = bddfalse;
+    m_p_out = m_q_out = bddfalse;
+    m_pair_states = bddfalse;
+    m_same_next_state = m_p_cube = m_q_cube = bddtrue;
+    m_automaton->get_dict()->unregister_all_my_variables(this);
+}
+
+bdd SymbolicPairStates::encode_state(StateCopy copy, unsigned state) const {
+    bdd encoded = bddtrue;
+    for (unsigned bit = 0; bit < m_state_bits; bit++) {
+        int var = state_bit_var(copy, bit);
+        encoded &= ((state >> bit) & 1) ? bdd_ithvar(var) : bdd_nithvar(var);
+    }
+    return encoded;
+}
+
+// OR of all the BDDs, as a balanced tree so the intermediate BDDs stay small
+static bdd balanced_or(std::vector<bdd>& bdds) {
+    if (bdds.empty()) {
+        return bddfalse;
+    }
+
+    for (size_t step = 1; step < bdds.size(); step *= 2) {
+        for (size_t i = 0; i + step < bdds.size(); i += 2 * step) {
+            bdds[i] |= bdds[i + step];
+            bdds[i + step] = bddfalse;
+        }
+    }
+    return bdds[0];
+}
+
+void SymbolicPairStates::build_transitions() {
+    /**
+     * For the p copy of the automaton:
+     *  - Δ_p(p, AP, p') = OR over the edges (src, cond, dst) of [p=src & cond & p'=dst]
+     *  - Moves_p(p, p') = OR over the edges (src, cond, dst) of [p=src & p'=dst]
+     * Moves_p is built from the edges (and not as ∃AP Δ_p), so edges labeled by
+     * bddfalse are kept, exactly as the explicit search does.
+     * The q copy is the same, after renaming p -> q and p' -> q'.
+     */
+    unsigned total_states = m_automaton->num_states();
+    vector<bdd> states_delta(total_states), states_moves(total_states),
+        states_out(total_states);
+
+    for (unsigned state = 0; state < total_states; state++) {
+        bdd delta = bddfalse, moves = bddfalse, out = bddfalse;
+
+        for (auto& edge : m_automaton->out(state)) {
+            bdd dst = encode_state(StateCopy::NextP, edge.dst);
+            delta |= edge.cond & dst;
+            moves |= dst;
+            out |= edge.cond;
+        }
+
+        bdd src = encode_state(StateCopy::P, state);
+        states_delta[state] = src & delta;
+        states_moves[state] = src & moves;
+        states_out[state] = src & out;
+    }
+
+    m_p_delta = balanced_or(states_delta);
+    m_p_moves = balanced_or(states_moves);
+    m_p_out = balanced_or(states_out);
+
+    bddPair* p_to_q = bdd_newpair();
+    for (unsigned bit = 0; bit < m_state_bits; bit++) {
+        bdd_setpair(p_to_q, state_bit_var(StateCopy::P, bit),
+                    state_bit_var(StateCopy::Q, bit));
+        bdd_setpair(p_to_q, state_bit_var(StateCopy::NextP, bit),
+                    state_bit_var(StateCopy::NextQ, bit));
+    }
+    m_q_delta = bdd_replace(m_p_delta, p_to_q);
+    m_q_moves = bdd_replace(m_p_moves, p_to_q);
+    m_q_out = bdd_replace(m_p_out, p_to_q);
+    bdd_freepair(p_to_q);
+
+    m_same_next_state = bddtrue;
+    for (unsigned bit = 0; bit < m_state_bits; bit++) {
+        m_same_next_state &=
+            bdd_biimp(bdd_ithvar(state_bit_var(StateCopy::NextP, bit)),
+                      bdd_ithvar(state_bit_var(StateCopy::NextQ, bit)));
+    }
+}
+
+bdd SymbolicPairStates::image(const bdd& pair_states) const {
+    /**
+     * T(p,q,p',q') = [∃AP: Δ_p & Δ_q] | [Moves_p & Moves_q & p'=q']
+     * T is never built as a single BDD (it is much larger than its parts), instead
+     * the image is computed by quantifying p and then q (and AP) one after another.
+     */
+    bdd by_p_delta = bdd_relprod(pair_states, m_p_delta, m_p_cube);
+    bdd shared_letter = bdd_relprod(by_p_delta, m_q_delta, m_q_cube & m_ap_cube);
+
+    bdd by_p_moves = bdd_relprod(pair_states, m_p_moves, m_p_cube);
+    bdd same_dst = bdd_relprod(by_p_moves, m_q_moves & m_same_next_state, m_q_cube);
+
+    return bdd_replace(shared_letter | same_dst, m_next_to_current);
+}
+
+bool SymbolicPairStates::compute() {
+    unsigned init_state = m_automaton->get_init_state_number();
+    m_pair_states = encode_state(StateCopy::P, init_state) &
+                    encode_state(StateCopy::Q, init_state);
+    bdd frontier = m_pair_states;
+
+    while (frontier != bddfalse) {
+        if (m_stop_flag.load()) {
+            return false;
+        }
+
+        frontier = image(frontier) & !m_pair_states;
+        m_pair_states |= frontier;
+    }
+
+    return !m_stop_flag.load();
+}
+
+double SymbolicPairStates::count_pair_states() const {
+    bdd same_state = bddtrue;
+    for (unsigned bit = 0; bit < m_state_bits; bit++) {
+        same_state &= bdd_biimp(bdd_ithvar(state_bit_var(StateCopy::P, bit)),
+                                bdd_ithvar(state_bit_var(StateCopy::Q, bit)));
+    }
+
+    bdd current_cube = m_p_cube & m_q_cube;
+    double total_ordered = bdd_satcountset(m_pair_states, current_cube);
+    double total_diagonal = bdd_satcountset(m_pair_states & same_state, current_cube);
+
+    return (total_ordered + total_diagonal) / 2;
+}
+
+bool SymbolicPairStates::has_collision(int dependent_var,
+                                       const vector<VarIndexer>& reset_vars) const {
+    // Replace in q's edges the reset_vars with their prime vars
+    bddPair* pairs = bdd_newpair();
+    for (auto& var : reset_vars) {
+        bdd_setpair(pairs, var.var_index, var.prime_var_index);
+    }
+    bdd q_out = bdd_replace(m_q_out, pairs);
+    bdd_freepair(pairs);
+
+    bdd p_positive = bdd_restrict(m_p_out, bdd_ithvar(dependent_var));
+    bdd q_negative = bdd_restrict(q_out, bdd_nithvar(dependent_var));
+
+    return bdd_have_common_assignment(m_pair_states & p_positive, q_negative);
+}
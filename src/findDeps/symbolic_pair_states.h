@@ -0,0 +1,85 @@
+#ifndef SYMBOLIC_PAIR_STATES_H
+#define SYMBOLIC_PAIR_STATES_H
+
+#include <atomic>
+#include <spot/twa/twagraph.hh>
+#include <vector>
+
+#include "find_deps_by_automaton.h"
+
+/**
+ * @brief Symbolic computation of the pair-states of an automaton.
+ *
+ * States are encoded in binary by BDD variables, 4 copies of the state bits are
+ * used: p, q (current pair-state) and p', q' (successor pair-state). The parts of the
+ * relation T(p,q,p',q') of "successors by the same letter" are built once, and the
+ * set of pair-states R(p,q) is computed as the least fixpoint of:
+ *      R = {(init, init)} ∪ Img_T(R)
+ *
+ * Unlike the explicit search, R is symmetric, i.e. both (p,q) and (q,p) are in R.
+ */
+class SymbolicPairStates {
+   private:
+    spot::twa_graph_ptr m_automaton;
+    std::atomic<bool>& m_stop_flag;
+
+    unsigned m_state_bits;
+    int m_vars_start;  // First BDD variable of the state bits
+
+    bdd m_p_cube;                // Conjunction of p's bits
+    bdd m_q_cube;                // Conjunction of q's bits
+    bdd m_ap_cube;               // Conjunction of the automaton's APs
+    bddPair* m_next_to_current;  // p' -> p, q' -> q
+
+    // Parts of the transition relation T(p,q,p',q'), see image()
+    bdd m_p_delta;          // Δ_p(p, AP, p')
+    bdd m_q_delta;          // Δ_q(q, AP, q')
+    bdd m_p_moves;          // Moves_p(p, p')
+    bdd m_q_moves;          // Moves_q(q, q')
+    bdd m_same_next_state;  // p' = q'
+
+    bdd m_p_out;        // Out(p, AP), the disjunction of p's outgoing edges
+    bdd m_q_out;        // Out(q, AP), the disjunction of q's outgoing edges
+    bdd m_pair_states;  // R(p,q)
+
+    enum StateCopy { P = 0, Q = 1, NextP = 2, NextQ = 3 };
+
+    int state_bit_var(StateCopy copy, unsigned bit) const {
+        // The 4 copies of each bit are interleaved in the BDD order
+        return m_vars_start + static_cast<int>(4 * bit + copy);
+    }
+
+    bdd encode_state(StateCopy copy, unsigned state) const;
+
+    void build_transitions();
+
+    // Successors of the pair-states by the same letter, over the variables p,q
+    bdd image(const bdd& pair_states) const;
+
+   public:
+    SymbolicPairStates(const spot::twa_graph_ptr& automaton,
+                       std::atomic<bool>& stop_flag);
+
+    ~SymbolicPairStates();
+
+    /**
+     * @brief Compute the pair-states as a least fixpoint.
+     * Return true if finished successfully and didn't stopped by the stop flag.
+     */
+    bool compute();
+
+    // Number of pair-states (p,q) where p <= q, as counted by the explicit search
+    double count_pair_states() const;
+
+    int get_bdd_size() const { return bdd_nodecount(m_pair_states); }
+
+    /**
+     * @brief Is there a pair-state (p,q) such that:
+     *      Out(p)[X=True, Z] & Out(q)[X=False, Z'] is satisfiable
+     * If yes, X is not dependent. Since R is symmetric, the opposite case
+     * (X=False in p, X=True in q) is covered by the pair-state (q,p).
+     */
+    bool has_collision(int dependent_var, const std::vector<VarIndexer>& reset_vars) const;
+};
+
+#endif
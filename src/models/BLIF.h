@@ -4,68 +4,36 @@
 #include <string>
 #include <spot/twaalgos/aiger.hh>
 #include <memory>
+#include <vector>
+
+#include "abc_utils.h"
 
 using namespace std;
 
 class BLIF;
 using BLIF_ptr = std::shared_ptr<BLIF>;
 
+/**
+ * A BLIF netlist of an AIG, used to pass the circuit to ABC.
+ */
 class BLIF {
 private:
-    string* m_blif_content;
+    string m_blif_content;
     string m_model_name;
+
 public:
-    BLIF(string model_name): m_model_name(model_name), m_blif_content(nullptr) {}
-    ~BLIF() {
-        if(m_blif_content != nullptr) {
-            delete m_blif_content;
-        }
-    }
+    BLIF(string model_name): m_model_name(model_name) {}
 
     void load_aig(spot::aig_ptr& aig);
 
-    void load_string(string& content);
-
-    void init_latch_to_one(string& latch_name);
-
-    string find_latch_name_by_num(unsigned latch_num);
-
-    spot::aig_ptr to_aig(spot::bdd_dict_ptr& dict);
-public:
-    friend ostream& operator<<(ostream& os, const BLIF& sm);
-
     /**
-     * Merge independent and dependent strategies into a single BLIF.
-     * The format of the merged BLIF:
-     *
-     * .model <model_name>
-     * .inputs <inputs>
-     * .outputs <outputs> // outputs = indep_vars + dep_vars
-     * .names <output>  // Create wired variables for output variables
-     *  1 1
-     *
-     * .subckt <indep_blif> <inputs> <indep_wired_vars>
-     * .subckt <dep_blif> <inputs> <indep_wired_vars> <dep_wired_vars>
-     *  .end
-     *
-     *  <indep_blif>
-     *  <dep_blif>
-     *
-     * @param indep_blif
-     * @param dep_blif
-     * @param inputs
-     * @param indep_vars
-     * @param dep_vars
-     * @param model_name
-     * @return BLIF of merged strategies
+     * @brief Optimize the circuit by an ABC script and convert it to AIG.
+     * @param abc_passes The commands of the script that ran, see AbcSession::optimize
      */
-    static BLIF_ptr merge_dependency_strategies(BLIF& indep_blif, BLIF& dep_blif,
-                                             const vector<string>& inputs,
-                                             const vector<string>& indep_vars,
-                                             const vector<string>& dep_vars,
-                                             string& model_name);
+    spot::aig_ptr to_aig(spot::bdd_dict_ptr& dict, const string& abc_script,
+                         Duration abc_time_budget, vector<AbcPass>& abc_passes);
+public:
+    friend ostream& operator<<(ostream& os, const BLIF& sm);
 };
 
-inline string blif_wired_var(const string& var) { return "In" + var; }
-
 #endif //REACTIVE_SYNTHESIS_BFSS_BLIF_H
@@ -2,6 +2,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <map>
 #include <spot/tl/parse.hh>
 #include <spot/tl/print.hh>
 #include <spot/twaalgos/aiger.hh>
@@ -9,15 +10,162 @@
 #include <string>
 #include <vector>
 
+// Above it, the states aren't encoded compactly (there are at most 2^#states sets)
+#define DEPENDENTS_MAX_STATES_SETS 4096
+
 using namespace std;
 using namespace spot;
 
-void DependentsSynthesiser::init_aiger() {
+spot::aig_ptr DependentsSynthesiser::synthesis() {
+    assert(m_original_conds.size() == m_nba->edge_vector().size());
+    assert(!m_dep_vars.empty() && "Dep Vars must be non-empty");
+
+    for (auto& var : m_dep_vars) {
+        m_dep_bdd_vars.push_back(this->ap_to_bdd_varnum(var));
+        deps_bdd_vars.insert(m_dep_bdd_vars.back());
+    }
+
+    vector<StateEncoding> encodings = {m_state_encoding};
+    if (m_state_encoding == StateEncoding::SMALLEST_ENCODING) {
+        encodings = {StateEncoding::ONE_HOT_ENCODING, StateEncoding::BINARY_ENCODING,
+                     StateEncoding::GRAY_ENCODING};
+    }
+    if (m_state_encoding != StateEncoding::ONE_HOT_ENCODING) {
+        find_states_sets();
+    }
+
+    // Keep the strategy with the fewest gates, by one-hot if no other encoding was built
+    aig_ptr strategy = nullptr;
+    for (auto encoding : encodings) {
+        if (!build_strategy(encoding)) {
+            continue;
+        }
+        if (m_is_realizable == Realizability::UNREALIZABLE) {
+            return nullptr;
+        }
+        if (strategy == nullptr || m_aiger->num_gates() < strategy->num_gates()) {
+            strategy = m_aiger;
+            m_aiger_state_encoding = encoding;
+        }
+    }
+    if (strategy == nullptr) {
+        build_strategy(StateEncoding::ONE_HOT_ENCODING);
+        if (m_is_realizable == Realizability::UNREALIZABLE) {
+            return nullptr;
+        }
+        strategy = m_aiger;
+        m_aiger_state_encoding = StateEncoding::ONE_HOT_ENCODING;
+    }
+
+    m_aiger = strategy;
+    return m_aiger;
+}
+
+bool DependentsSynthesiser::build_strategy(StateEncoding encoding) {
+    unsigned num_latches = m_nba->num_states();
+    if (encoding != StateEncoding::ONE_HOT_ENCODING &&
+        !encode_states_sets(encoding, num_latches)) {
+        return false;
+    }
+
+    init_aiger(num_latches);
+    if (encoding == StateEncoding::ONE_HOT_ENCODING) {
+        define_next_latches();
+    } else {
+        define_encoded_next_latches();
+    }
+    define_output_gates();
+
+    AigerDescription description;
+    extract_aiger_description(description, m_aiger);
+    description.state_encoding = state_encoding_to_string(encoding);
+    m_encodings.push_back(description);
+    return true;
+}
+
+bool DependentsSynthesiser::find_states_sets() {
+    assert(m_nba->get_init_state_number() == 0 && "Init state of nba without deps must be 0");
+
+    /**
+     * The one-hot latches hold the set of states of all the runs of the projected NBA,
+     * so its reachable sets are found by the subset construction. The conditions of the
+     * edges of a set are split into the letters leading to each successor set.
+     */
+    map<std::set<State>, unsigned> set_index;
+    m_states_sets.push_back({0});
+    m_states_sets_edges.emplace_back();
+    set_index[m_states_sets[0]] = 0;
+
+    for (unsigned set_idx = 0; set_idx < m_states_sets.size(); set_idx++) {
+        map<std::set<State>, bdd> successors = {{{}, bddtrue}};
+        for (State state : m_states_sets[set_idx]) {
+            for (auto& transition : m_nba->out(state)) {
+                map<std::set<State>, bdd> refined;
+                for (auto& successor : successors) {
+                    bdd taken = successor.second & transition.cond;
+                    bdd not_taken = successor.second & !transition.cond;
+                    if (taken != bddfalse) {
+                        std::set<State> successor_set = successor.first;
+                        successor_set.insert(transition.dst);
+                        refined[successor_set] |= taken;
+                    }
+                    if (not_taken != bddfalse) {
+                        refined[successor.first] |= not_taken;
+                    }
+                }
+                successors.swap(refined);
+            }
+        }
+
+        for (auto& successor : successors) {
+            auto found_set = set_index.find(successor.first);
+            unsigned successor_idx;
+            if (found_set != set_index.end()) {
+                successor_idx = found_set->second;
+            } else {
+                if (m_states_sets.size() >= DEPENDENTS_MAX_STATES_SETS) {
+                    m_states_sets.clear();
+                    m_states_sets_edges.clear();
+                    return false;
+                }
+                successor_idx = m_states_sets.size();
+                set_index[successor.first] = successor_idx;
+                m_states_sets.push_back(successor.first);
+                m_states_sets_edges.emplace_back();
+            }
+            m_states_sets_edges[set_idx].emplace_back(successor.second, successor_idx);
+        }
+    }
+    return true;
+}
+
+bool DependentsSynthesiser::encode_states_sets(StateEncoding encoding,
+                                               unsigned& num_latches) {
+    if (m_states_sets.empty()) {
+        return false;  // Too many sets of states
+    }
+
+    num_latches = 1;
+    while ((1u << num_latches) < m_states_sets.size()) {
+        num_latches++;
+    }
+
+    m_states_sets_codes.clear();
+    for (unsigned set_idx = 0; set_idx < m_states_sets.size(); set_idx++) {
+        unsigned code =
+            encoding == StateEncoding::GRAY_ENCODING ? set_idx ^ (set_idx >> 1) : set_idx;
+        // The initial set is the first one, its code is 1 as only the first latch starts at 1
+        m_states_sets_codes.push_back(code ^ 1);
+    }
+    return true;
+}
+
+void DependentsSynthesiser::init_aiger(unsigned num_latches) {
     /**
      * Create AIGER
      * Input = Input Vars + Indep Vars
      * Output = Dep Vars
-     * Latches = #States
+     * Latches = #States, or the bits of the codes of the sets of states
      */
     std::vector<std::string> aiger_inputs;
     std::copy(m_input_vars.begin(), m_input_vars.end(),
@@ -25,20 +173,17 @@ void DependentsSynthesiser::init_aiger() {
     std::copy(m_indep_vars.begin(), m_indep_vars.end(),
               std::back_inserter(aiger_inputs));
 
-    unsigned num_latches = m_nba_with_deps->num_states();
     m_aiger = std::make_shared<aig>(aiger_inputs, m_dep_vars, num_latches,
-                                    m_nba_with_deps->get_dict());
+                                    m_nba->get_dict());
 
-    /**
-     * Preprocessed data
-     */
-    for (auto& var : m_dep_vars) {
-        deps_bdd_vars.insert(this->ap_to_bdd_varnum(var));
-    }
+    // The gates of the previous strategy are of another AIGER
+    m_partial_impl_by_dep.assign(m_dep_vars.size(), {});
+    m_dep_free_impl.clear();
+    m_state_gates.assign(m_nba->num_states(), m_aiger->aig_false());
 }
 
 void DependentsSynthesiser::define_next_latches() {
-    assert(m_nba_without_deps->get_init_state_number() == 0 && "Init state of nba without deps must be 0");
+    assert(m_nba->get_init_state_number() == 0 && "Init state of nba without deps must be 0");
 
     /**
      * Define next latches values
@@ -47,8 +192,8 @@ void DependentsSynthesiser::define_next_latches() {
      * transition (src, gate, dst) exists in the projected NBA
      */
     unordered_map<State, std::vector<StateGatePair>> dst_transitions;
-    for (State state = 0; state < m_nba_without_deps->num_states(); state++) {
-        for (auto& transition : m_nba_without_deps->out(state)) {
+    for (State state = 0; state < m_nba->num_states(); state++) {
+        for (auto& transition : m_nba->out(state)) {
             State src = transition.src;
             State dst = transition.dst;
             bdd& cond = transition.cond;
@@ -82,93 +227,175 @@ void DependentsSynthesiser::define_next_latches() {
     }
 
     // States which do not have any transition
-    for (State state = 0; state < m_nba_without_deps->num_states(); state++) {
+    for (State state = 0; state < m_nba->num_states(); state++) {
         if (dst_transitions.find(state) == dst_transitions.end()) {
             m_aiger->set_next_latch(state, m_aiger->aig_false());
         }
+        m_state_gates[state] = m_aiger->latch_var(state);
     }
 }
 
-void DependentsSynthesiser::define_output_gates() {
-    m_is_realizable = Realizability::REALIZABLE;
+void DependentsSynthesiser::define_encoded_next_latches() {
+    /**
+     * The latches hold the code of the set of states. The next value of a latch is
+     * OR_set (code(set) & the letters to successor sets whose code has the latch's bit),
+     * and a state is active if the code is of a set containing it. The codes of no set
+     * are unreachable, so they are don't cares of the BDDs.
+     */
+    vector<bdd> sets_codes;
+    bdd reachable_codes = bddfalse;
+    for (unsigned code : m_states_sets_codes) {
+        bdd code_bdd = bddtrue;
+        for (unsigned latch = 0; latch < m_aiger->num_latches(); latch++) {
+            code_bdd &= m_aiger->latch_bdd(latch, ((code >> latch) & 1) == 0);
+        }
+        sets_codes.push_back(code_bdd);
+        reachable_codes |= code_bdd;
+    }
 
-    for (unsigned dep_idx = 0; dep_idx < m_dep_vars.size(); dep_idx++) {
-        string& dep_var = m_dep_vars[dep_idx];
-        vector<Gate> dependent_conds;
-
-        // For all transitions (src, cond, dst)
-        for (State state = 0; state < m_nba_with_deps->num_states(); state++) {
-            for (auto& transition : m_nba_with_deps->out(state)) {
-                State src = transition.src;
-                bdd& cond = transition.cond;
-
-                Gate partial_impl = get_partial_impl(cond, dep_var);
-
-                std::vector<unsigned> dependent_edge_cond = {
-                    m_aiger->latch_var(src),
-                    m_aiger->bdd2INFvar(m_bdd_to_bdd_without_deps[transition.cond.id()]),
-                    partial_impl
-                };
-                dependent_conds.emplace_back(m_aiger->aig_and(dependent_edge_cond));
+    for (unsigned latch = 0; latch < m_aiger->num_latches(); latch++) {
+        bdd next_latch = bddfalse;
+        for (unsigned set_idx = 0; set_idx < m_states_sets.size(); set_idx++) {
+            bdd letters = bddfalse;
+            for (auto& edge : m_states_sets_edges[set_idx]) {
+                if ((m_states_sets_codes[edge.second] >> latch) & 1) {
+                    letters |= edge.first;
+                }
             }
+            next_latch |= sets_codes[set_idx] & letters;
         }
+        next_latch = bdd_simplify(next_latch, reachable_codes);
+        m_aiger->set_next_latch(latch, m_aiger->bdd2INFvar(next_latch));
+    }
 
-        if(dependent_conds.empty()) {
-            // Unrealizable
-            m_is_realizable = Realizability::UNREALIZABLE;
-            return;
+    vector<bdd> states_conds(m_nba->num_states(), bddfalse);
+    for (unsigned set_idx = 0; set_idx < m_states_sets.size(); set_idx++) {
+        for (State state : m_states_sets[set_idx]) {
+            states_conds[state] |= sets_codes[set_idx];
         }
-        m_aiger->set_output(dep_idx, m_aiger->aig_or(dependent_conds));
+    }
+    for (State state = 0; state < m_nba->num_states(); state++) {
+        bdd state_cond = bdd_simplify(states_conds[state], reachable_codes);
+        m_state_gates[state] = m_aiger->bdd2INFvar(state_cond);
     }
 }
 
-Gate DependentsSynthesiser::get_partial_impl(const bdd& cond, string& dep_var) {
-    string partial_impl_key = std::to_string(cond.id()) + "#" + dep_var;
+void DependentsSynthesiser::define_output_gates() {
+    m_is_realizable = Realizability::REALIZABLE;
 
-    // If exists in cache
-    if (partial_impl_cache.find(partial_impl_key) != partial_impl_cache.end()) {
-        return partial_impl_cache[partial_impl_key];
+    /**
+     * The output of a dependent is OR_src (in(src) & OR_edges (proj_cond & impl)),
+     * i.e. whether the NBA is in a state is ANDed once with the edges of the state, and the edges
+     * are grouped by their projected condition (and their identical conditions merged).
+     * The groups don't depend on the dependent variable, so they are built once.
+     */
+    struct EdgesGroup {
+        Gate projected_cond;
+        vector<bdd> conds;
+    };
+    vector<vector<EdgesGroup>> groups_by_state(m_nba->num_states());
+    for (State state = 0; state < m_nba->num_states(); state++) {
+        vector<EdgesGroup>& groups = groups_by_state[state];
+        unordered_map<int, size_t> group_by_projected_cond;
+        unordered_set<int> grouped_conds;
+
+        for (auto& transition : m_nba->out(state)) {
+            const bdd& cond = m_original_conds[m_nba->edge_number(transition)];
+            if (!grouped_conds.insert(cond.id()).second) {
+                continue;  // Same condition as another edge, to another state
+            }
+
+            bdd& projected_cond = transition.cond;
+            auto group = group_by_projected_cond.find(projected_cond.id());
+            if (group == group_by_projected_cond.end()) {
+                group_by_projected_cond[projected_cond.id()] = groups.size();
+                groups.push_back({m_aiger->bdd2INFvar(projected_cond), {cond}});
+            } else {
+                groups[group->second].conds.push_back(cond);
+            }
+        }
     }
 
-    // Create partial implementation
-    unordered_map<int, Gate> bdds_partial_impl;
-    Gate partial_impl = generate_partial_impl(cond, dep_var, bdds_partial_impl);
+    for (unsigned dep_idx = 0; dep_idx < m_dep_vars.size(); dep_idx++) {
+        vector<Gate> states_conds;
+
+        for (State state = 0; state < m_nba->num_states(); state++) {
+            vector<Gate> edges_conds;
+            for (auto& group : groups_by_state[state]) {
+                vector<Gate> partial_impls;
+                for (auto& cond : group.conds) {
+                    partial_impls.push_back(get_partial_impl(cond, dep_idx));
+                }
+                edges_conds.push_back(
+                    m_aiger->aig_and(group.projected_cond, m_aiger->aig_or(partial_impls)));
+            }
 
-    // Store to cache and return it
-    partial_impl_cache[partial_impl_key] = partial_impl;
-    return partial_impl_cache[partial_impl_key];
+            if (!edges_conds.empty()) {
+                // aig_or is a balanced tree of the gates
+                states_conds.push_back(m_aiger->aig_and(m_state_gates[state],
+                                                        m_aiger->aig_or(edges_conds)));
+            }
+        }
+
+        if(states_conds.empty()) {
+            // Unrealizable
+            m_is_realizable = Realizability::UNREALIZABLE;
+            return;
+        }
+        m_aiger->set_output(dep_idx, m_aiger->aig_or(states_conds));
+    }
 }
 
-Gate DependentsSynthesiser::generate_partial_impl(
-    const bdd& cond, string& dep_var, unordered_map<int, Gate>& bdd_partial_impl) {
+Gate DependentsSynthesiser::get_partial_impl(const bdd& cond, unsigned dep_idx) {
     if (cond == bddtrue) {
         return m_aiger->aig_true();
     }
     if (cond == bddfalse) {
         return m_aiger->aig_false();
     }
-    if (bdd_partial_impl.find(cond.id()) != bdd_partial_impl.end()) {
-        return bdd_partial_impl[cond.id()];
+
+    // If exists in cache
+    auto dep_free_impl = m_dep_free_impl.find(cond.id());
+    if (dep_free_impl != m_dep_free_impl.end()) {
+        return dep_free_impl->second;
+    }
+    unordered_map<int, Gate>& dep_impls = m_partial_impl_by_dep[dep_idx];
+    auto dep_impl = dep_impls.find(cond.id());
+    if (dep_impl != dep_impls.end()) {
+        return dep_impl->second;
     }
 
+    // Create partial implementation and store it to cache
+    bool is_dep_free;
+    Gate partial_impl = generate_partial_impl(cond, dep_idx, is_dep_free);
+    if (is_dep_free) {
+        m_dep_free_impl[cond.id()] = partial_impl;
+    } else {
+        dep_impls[cond.id()] = partial_impl;
+    }
+    return partial_impl;
+}
+
+Gate DependentsSynthesiser::generate_partial_impl(const bdd& cond, unsigned dep_idx,
+                                                  bool& is_dep_free) {
     // Post-order traversal
-    Gate high_gate =
-        generate_partial_impl(bdd_high(cond), dep_var, bdd_partial_impl);
-    Gate low_gate = generate_partial_impl(bdd_low(cond), dep_var, bdd_partial_impl);
+    bdd high = bdd_high(cond), low = bdd_low(cond);
+    Gate high_gate = get_partial_impl(high, dep_idx);
+    Gate low_gate = get_partial_impl(low, dep_idx);
 
     bool is_dep_var = deps_bdd_vars.find(bdd_var(cond)) != deps_bdd_vars.end();
+    is_dep_free = !is_dep_var && is_dep_free_impl(high) && is_dep_free_impl(low);
     Gate n_v, neg_n_v;
 
     if (!is_dep_var) {
         n_v = m_aiger->bdd2aigvar(bdd_ithvar(bdd_var(cond)));
         neg_n_v = m_aiger->aig_not(n_v);
     } else {
-        bool is_bdd_var_cur_dep = bdd_var(cond) == ap_to_bdd_varnum(dep_var);
+        bool is_bdd_var_cur_dep = bdd_var(cond) == m_dep_bdd_vars[dep_idx];
         neg_n_v = is_bdd_var_cur_dep ? m_aiger->aig_false() : m_aiger->aig_true();
         n_v = m_aiger->aig_true();
     }
 
-    bdd_partial_impl[cond.id()] = m_aiger->aig_or(
-        m_aiger->aig_and(neg_n_v, low_gate), m_aiger->aig_and(n_v, high_gate));
-    return bdd_partial_impl[cond.id()];
+    return m_aiger->aig_or(m_aiger->aig_and(neg_n_v, low_gate),
+                           m_aiger->aig_and(n_v, high_gate));
 }
@@ -3,6 +3,7 @@
 
 #include <algorithm>
 #include <iostream>
+#include <set>
 #include <spot/tl/parse.hh>
 #include <spot/twa/fwd.hh>
 #include <spot/twa/twa.hh>
@@ -12,6 +13,9 @@
 #include <utility>
 #include <vector>
 
+#include "synt_measure.h"
+#include "utils.h"
+
 using State = unsigned;
 using Gate = unsigned;
 using BDDVar = int;
@@ -23,69 +27,95 @@ using namespace std;
 class DependentsSynthesiser {
     enum Realizability { REALIZABLE, UNREALIZABLE, UNKNOWN };
    private:
-    spot::twa_graph_ptr m_nba_without_deps;
-    spot::twa_graph_ptr m_nba_with_deps;
+    // The NBA without the dependents, its edges' original conditions include them
+    spot::twa_graph_ptr m_nba;
+    const std::vector<bdd>& m_original_conds;
     std::vector<std::string> m_input_vars;
     std::vector<std::string> m_indep_vars;
     std::vector<std::string> m_dep_vars;
 
     aig_ptr m_aiger;
+    StateEncoding m_state_encoding;
+    StateEncoding m_aiger_state_encoding;      // The encoding m_aiger was built by
+    vector<AigerDescription> m_encodings;      // The strategy of each encoding built
+    vector<Gate> m_state_gates;                // Whether the NBA is in a state
+
+    // The reachable sets of states of the projected NBA (i.e. the values of the one-hot
+    // latches), their edges (condition, successor set) and their codes by the latches
+    vector<std::set<State>> m_states_sets;
+    vector<vector<pair<bdd, unsigned>>> m_states_sets_edges;
+    vector<unsigned> m_states_sets_codes;
 
     unordered_set<BDDVar> deps_bdd_vars;
-    unordered_map<string, Gate> partial_impl_cache;
-    unordered_map<int, bdd>& m_bdd_to_bdd_without_deps;
+    vector<BDDVar> m_dep_bdd_vars;  // BDD variable of each of m_dep_vars
+    // Partial implementations by BDD id: of each dependent output, and of the sub-BDDs
+    // without dependent variables, which are the same for all the outputs
+    vector<unordered_map<int, Gate>> m_partial_impl_by_dep;
+    unordered_map<int, Gate> m_dep_free_impl;
 
     Realizability m_is_realizable;
 
-    void init_aiger();
+    bool build_strategy(StateEncoding encoding);
+
+    bool find_states_sets();
+
+    bool encode_states_sets(StateEncoding encoding, unsigned& num_latches);
+
+    void init_aiger(unsigned num_latches);
 
     void define_next_latches();
 
+    void define_encoded_next_latches();
+
     void define_output_gates();
 
-    Gate get_partial_impl(const bdd& cond, string& dep_var);
+    Gate get_partial_impl(const bdd& cond, unsigned dep_idx);
 
-    Gate generate_partial_impl(const bdd& cond, string& dep_var,
-                               unordered_map<int, Gate>& bdd_partial_impl);
+    Gate generate_partial_impl(const bdd& cond, unsigned dep_idx, bool& is_dep_free);
+
+    bool is_dep_free_impl(const bdd& cond) const {
+        return cond == bddtrue || cond == bddfalse ||
+               m_dep_free_impl.find(cond.id()) != m_dep_free_impl.end();
+    }
 
     BDDVar ap_to_bdd_varnum(string& ap) {
-        return m_nba_with_deps->register_ap(ap);
+        // The dependents aren't APs of the NBA anymore, their original conditions keep
+        // them registered
+        return m_nba->get_dict()->varnum(spot::formula::ap(ap));
     }
 
    public:
     DependentsSynthesiser(spot::twa_graph_ptr& nba_without_deps,
-                          spot::twa_graph_ptr& nba_with_deps,
                           std::vector<std::string>& input_vars,
                           std::vector<std::string>& indep_vars,
                           std::vector<std::string>& dep_vars,
-                          unordered_map<int, bdd>& bdd_to_bdd_without_deps)
-        : m_nba_without_deps(nba_without_deps),
-          m_nba_with_deps(nba_with_deps),
+                          const std::vector<bdd>& original_conds)
+        : m_nba(nba_without_deps),
+          m_original_conds(original_conds),
           m_input_vars(input_vars),
           m_indep_vars(indep_vars),
-          m_bdd_to_bdd_without_deps(bdd_to_bdd_without_deps),
           m_is_realizable(Realizability::UNKNOWN),
+          m_state_encoding(StateEncoding::ONE_HOT_ENCODING),
+          m_aiger_state_encoding(StateEncoding::ONE_HOT_ENCODING),
           m_dep_vars(dep_vars){};
 
-    Realizability is_realizable() {
-        return m_is_realizable;
-    }
-
-    spot::aig_ptr synthesis() {
-        assert(m_nba_with_deps->num_states() == m_nba_without_deps->num_states());
-        assert(m_nba_with_deps->get_dict() == m_nba_without_deps->get_dict());
-        assert(!m_dep_vars.empty() && "Dep Vars must be non-empty");
+    void set_state_encoding(StateEncoding encoding) { m_state_encoding = encoding; }
 
+    // The encoding of the synthesized strategy
+    StateEncoding get_state_encoding() const { return m_aiger_state_encoding; }
 
-        init_aiger();
-        define_next_latches();
-        define_output_gates();
+    const vector<AigerDescription>& get_encodings() const { return m_encodings; }
 
-        if(m_is_realizable == Realizability::UNREALIZABLE) {
-            return nullptr;
-        }
-        return m_aiger;
+    Realizability is_realizable() {
+        return m_is_realizable;
     }
+
+    /**
+     * @brief Synthesize the strategy of the dependent variables, nullptr if unrealizable.
+     * The latch of the initial state (the first one by one-hot encoding, otherwise the
+     * first bit of the code) must start at 1, i.e. the initial code is 1.
+     */
+    spot::aig_ptr synthesis();
 };
 
 #endif
\ No newline at end of file
@@ -1,9 +1,56 @@
 #include "merge_strategies.h"
 
-void load_dependent_strategy(BLIF& deps_blif, spot::aig_ptr& dependent_strategy) {
-    deps_blif.load_aig(dependent_strategy);
-    string deps_init_latch = deps_blif.find_latch_name_by_num(dependent_strategy->latch_var(0));
-    deps_blif.init_latch_to_one(deps_init_latch);
+#include <stdexcept>
+#include <unordered_map>
+
+// Literal of the merged strategy of a strategy's literal, var_to_lit maps the strategy's
+// variables to the merged strategy's literals
+static unsigned map_literal(spot::aig_ptr& merged, const vector<unsigned>& var_to_lit,
+                            unsigned lit) {
+    unsigned merged_lit = var_to_lit[lit / 2];
+    return (lit & 1) ? merged->aig_not(merged_lit) : merged_lit;
+}
+
+/**
+ * @brief Add the gates of a strategy to the merged strategy. The inputs are wired by
+ * their names, the latches are mapped to the merged latches from first_latch on. If
+ * negate_init_latch, the first latch is stored negated, so it starts at 1.
+ */
+static void copy_strategy(spot::aig_ptr& merged, const spot::aig_ptr& strategy,
+                          const unordered_map<string, unsigned>& wires,
+                          unsigned first_latch, bool negate_init_latch,
+                          vector<unsigned>& var_to_lit) {
+    unsigned total_vars = 1 + strategy->num_inputs() + strategy->num_latches() +
+                          strategy->num_gates();
+    var_to_lit.assign(total_vars, spot::aig::aig_false());
+
+    for (unsigned i = 0; i < strategy->num_inputs(); i++) {
+        auto wire = wires.find(strategy->input_names()[i]);
+        if (wire == wires.end()) {
+            throw std::runtime_error("Can't merge strategies, the input " +
+                                     strategy->input_names()[i] + " isn't wired");
+        }
+        var_to_lit[strategy->input_var(i) / 2] = wire->second;
+    }
+    for (unsigned i = 0; i < strategy->num_latches(); i++) {
+        bool is_negated = negate_init_latch && i == 0;
+        var_to_lit[strategy->latch_var(i) / 2] = merged->latch_var(first_latch + i, is_negated);
+    }
+
+    // A gate is created after its operands, so they are already mapped
+    for (unsigned i = 0; i < strategy->num_gates(); i++) {
+        auto& gate = strategy->gates()[i];
+        var_to_lit[strategy->gate_var(i) / 2] =
+            merged->aig_and(map_literal(merged, var_to_lit, gate.first),
+                            map_literal(merged, var_to_lit, gate.second));
+    }
+
+    for (unsigned i = 0; i < strategy->num_latches(); i++) {
+        unsigned next_lit = map_literal(merged, var_to_lit, strategy->next_latches()[i]);
+        bool is_negated = negate_init_latch && i == 0;
+        merged->set_next_latch(first_latch + i,
+                               is_negated ? merged->aig_not(next_lit) : next_lit);
+    }
 }
 
 spot::aig_ptr merge_strategies(spot::aig_ptr independent_strategy,
@@ -11,25 +58,53 @@ spot::aig_ptr merge_strategies(spot::aig_ptr independent_strategy,
                                 const vector<string>& inputs,
                                 const vector<string>& independent_vars,
                                 const vector<string>& dependent_vars,
-                                spot::bdd_dict_ptr dict, string& model_name) {
+                                spot::bdd_dict_ptr dict) {
     if (dependent_vars.empty() || dependent_strategy == nullptr) {
         return independent_strategy;
     }
-    if (independent_vars.empty() || independent_strategy == nullptr) {
+    if (independent_vars.empty()) {
         // Only fix the latch corresponding to the initial state
-        BLIF deps_blif(model_name + "deps");
-        load_dependent_strategy(deps_blif, dependent_strategy);
-        return deps_blif.to_aig(dict);
+        independent_strategy = nullptr;
     }
 
-    // Create a BLIF file for each strategy
-    BLIF deps_blif(model_name + "deps"), indeps_blif(model_name + "indeps");
-    indeps_blif.load_aig(independent_strategy);
-    load_dependent_strategy(deps_blif, dependent_strategy);
+    vector<string> outputs;
+    if (independent_strategy != nullptr) {
+        outputs = independent_strategy->output_names();
+    }
+    outputs.insert(outputs.end(), dependent_strategy->output_names().begin(),
+                   dependent_strategy->output_names().end());
 
-    // Merge strategies
-    auto merged_blif = BLIF::merge_dependency_strategies(indeps_blif, deps_blif, inputs, independent_vars, dependent_vars, model_name);
-    return merged_blif->to_aig(dict);
-}
+    unsigned total_independent_latches =
+        independent_strategy != nullptr ? independent_strategy->num_latches() : 0;
+    auto merged = std::make_shared<spot::aig>(
+        inputs, outputs, total_independent_latches + dependent_strategy->num_latches(),
+        dict);
 
+    // Name -> literal of the merged strategy, for the inputs and the independent outputs
+    unordered_map<string, unsigned> wires;
+    for (unsigned i = 0; i < inputs.size(); i++) {
+        wires.emplace(inputs[i], merged->input_var(i));
+    }
 
+    vector<unsigned> var_to_lit;
+    unsigned output = 0;
+    if (independent_strategy != nullptr) {
+        copy_strategy(merged, independent_strategy, wires, 0, false, var_to_lit);
+        for (unsigned i = 0; i < independent_strategy->num_outputs(); i++, output++) {
+            unsigned lit = map_literal(merged, var_to_lit, independent_strategy->outputs()[i]);
+            wires.emplace(independent_strategy->output_names()[i], lit);
+            merged->set_output(output, lit);
+        }
+    }
+
+    // The dependent strategy encodes its states by latches, the initial state is the
+    // first one, so it must start at 1
+    copy_strategy(merged, dependent_strategy, wires, total_independent_latches, true,
+                  var_to_lit);
+    for (unsigned i = 0; i < dependent_strategy->num_outputs(); i++, output++) {
+        merged->set_output(output,
+                           map_literal(merged, var_to_lit, dependent_strategy->outputs()[i]));
+    }
+
+    return merged;
+}
@@ -3,17 +3,24 @@
 
 #include <spot/twa/bdddict.hh>
 #include <spot/twaalgos/aiger.hh>
-#include "BLIF.h"
+#include <string>
+#include <vector>
 
 using namespace std;
 
-// Input: Dependent AIG, Independent AIG, Inputs, Independent Vars, Dependent Vars
-// Output: Merged AIG
+/**
+ * Input: Dependent AIG, Independent AIG, Inputs, Independent Vars, Dependent Vars
+ * Output: Merged AIG
+ *
+ * The merged AIG is built in memory: the dependent strategy's inputs of the independent
+ * variables are wired to the independent strategy's outputs, and the latches of both
+ * strategies are kept (independent ones first).
+ */
 spot::aig_ptr merge_strategies(spot::aig_ptr independent_strategy,
                       spot::aig_ptr dependent_strategy,
                       const vector<string>& inputs,
                       const vector<string>& independent_vars,
                       const vector<string>& dependent_vars,
-                      spot::bdd_dict_ptr dict, string& model_name);
+                      spot::bdd_dict_ptr dict);
 
 #endif //REACTIVE_SYNTHESIS_BFSS_MERGE_STRATEGIES_H
@@ -1,25 +1,34 @@
 #include "synthesis_utils.h"
 
+#include "compact_nba.h"
+#include "nba_cache.h"
+
 using namespace std;
 using namespace spot;
 
 void remove_ap_from_automaton(const twa_graph_ptr& automaton,
-                              vector<string>& variables, unordered_map<int, bdd>& bdd_to_bdd_without_deps) {
+                              vector<string>& variables) {
+    auto original_conds = new OriginalConditions(automaton->get_dict());
     bdd vars = bddtrue;
     for (string& ap_name : variables) {
         vars &= bdd_ithvar(automaton->register_ap(ap_name));
+        original_conds->dict->register_proposition(formula::ap(ap_name), original_conds);
     }
 
-    // Apply exists operator on all edges
-    for (int i = 0; i < automaton->num_states(); i++) {
-        for (auto& edge : automaton->out(i)) {
-            if(bdd_to_bdd_without_deps.find(edge.cond.id()) == bdd_to_bdd_without_deps.end()) {
-                bdd_to_bdd_without_deps[edge.cond.id()] = bdd_exist(edge.cond, vars);
-            }
+    // Apply exists operator once per distinct condition, then on all edges
+    CompactNBA compact_nba(automaton);
+    vector<bdd> conds_without_deps(compact_nba.num_conds());
+    for (unsigned cond_id = 0; cond_id < compact_nba.num_conds(); cond_id++) {
+        conds_without_deps[cond_id] = bdd_exist(compact_nba.cond(cond_id), vars);
+    }
 
-            edge.cond = bdd_to_bdd_without_deps[edge.cond.id()];
-        }
+    original_conds->conds.resize(automaton->edge_vector().size());
+    for (unsigned edge = 0; edge < compact_nba.num_edges(); edge++) {
+        auto& edge_storage = automaton->edge_storage(compact_nba.edge_num(edge));
+        original_conds->conds[compact_nba.edge_num(edge)] = edge_storage.cond;
+        edge_storage.cond = conds_without_deps[compact_nba.edge_cond_id(edge)];
     }
+    automaton->set_named_prop(ORIGINAL_CONDITIONS_PROP, original_conds);
 
     // Unregister dependent variables
     for (string& var_to_remove : variables) {
@@ -28,6 +37,15 @@ void remove_ap_from_automaton(const twa_graph_ptr& automaton,
     }
 }
 
+const vector<bdd>& get_original_conditions(const twa_graph_ptr& automaton) {
+    auto original_conds =
+        automaton->get_named_prop<OriginalConditions>(ORIGINAL_CONDITIONS_PROP);
+    if (original_conds == nullptr) {
+        throw std::runtime_error("The automaton has no original conditions");
+    }
+    return original_conds->conds;
+}
+
 spot::twa_graph_ptr get_dpa_from_nba(spot::twa_graph_ptr nba, synthesis_info& gi,
                                      const vector<string>& output_vars) {
     auto tobdd = [&nba](const std::string& ap_name) {
@@ -45,11 +63,34 @@ spot::twa_graph_ptr get_dpa_from_nba(spot::twa_graph_ptr nba, synthesis_info& gi
             outs &= tobdd(aap.ap_name());
         }
     }
-    auto splitted = split_2step(nba, outs, true);
-
-    auto dpa = ntgba2dpa(splitted, gi.force_sbacc);
-    // Transform an automaton into a parity game by propagating players.
-    alternate_players(dpa);
+    // As Spot's ltl_to_game, but from the NBA instead of the formula
+    twa_graph_ptr dpa;
+    switch (gi.s) {
+        case synthesis_info::algo::DET_SPLIT:
+            dpa = ntgba2dpa(nba, gi.force_sbacc);
+            break;
+        // LAR and ACD only change the acceptance, the NBA must be determinized first
+        case synthesis_info::algo::LAR:
+            dpa = to_parity(is_deterministic(nba) ? nba : tgba_determinize(nba));
+            break;
+        case synthesis_info::algo::ACD:
+            dpa = acd_transform(is_deterministic(nba) ? nba : tgba_determinize(nba));
+            break;
+        default: {
+            auto splitted = split_2step(nba, outs, true);
+
+            dpa = ntgba2dpa(splitted, gi.force_sbacc);
+            // Transform an automaton into a parity game by propagating players.
+            alternate_players(dpa);
+            break;
+        }
+    }
+    if (gi.s == synthesis_info::algo::DET_SPLIT || gi.s == synthesis_info::algo::LAR ||
+        gi.s == synthesis_info::algo::ACD) {
+        change_parity_here(dpa, parity_kind_max, parity_style_odd);
+        dpa = split_2step(dpa, outs, true);
+        colorize_parity_here(dpa, true);
+    }
     // Merge states knows about players
     dpa->merge_states();
     set_synthesis_outputs(dpa, outs);
@@ -57,10 +98,11 @@ spot::twa_graph_ptr get_dpa_from_nba(spot::twa_graph_ptr nba, synthesis_info& gi
     return dpa;
 }
 
-spot::twa_graph_ptr get_nba_for_synthesis(const spot::formula& formula,
+spot::twa_graph_ptr get_nba_for_synthesis(SyntInstance& synt_instance,
                                           synthesis_info& gi,
                                           BaseMeasures& synt_measures,
-                                          std::ostream& verbose) {
+                                          std::ostream& verbose,
+                                          const std::string& nba_cache_dir) {
     option_map& extra_options = gi.opt;
     const bdd_dict_ptr& dict = gi.dict;
 
@@ -68,12 +110,31 @@ spot::twa_graph_ptr get_nba_for_synthesis(const spot::formula& formula,
     extra_options.set_if_unset("tls-impl", 1);
     extra_options.set_if_unset("wdba-minimize", gi.minimize_lvl);
 
+    std::unique_ptr<NBACache> nba_cache;
+    string nba_cache_key;
+    if (!nba_cache_dir.empty()) {
+        nba_cache.reset(new NBACache(nba_cache_dir));
+        nba_cache_key = NBACache::make_key(synt_instance, extra_options, dict);
+
+        synt_measures.start_automaton_construct();
+        auto cached_automaton = nba_cache->load(nba_cache_key, dict);
+        if (cached_automaton != nullptr) {
+            verbose << "=> Loaded the pruned automaton from the NBA cache" << endl;
+            synt_measures.end_automaton_construct(cached_automaton);
+            synt_measures.start_prune_automaton();
+            synt_measures.end_prune_automaton(cached_automaton);
+            synt_measures.add_nba_cache_hit();
+            return cached_automaton;
+        }
+        synt_measures.add_nba_cache_miss();
+    }
+
     synt_measures.start_automaton_construct();
     translator trans(dict, &extra_options);
     trans.set_type(spot::postprocessor::Buchi);
     trans.set_pref(spot::postprocessor::SBAcc);
 
-    auto automaton = trans.run(formula);
+    auto automaton = trans.run(synt_instance.get_formula_parsed());
     synt_measures.end_automaton_construct(automaton);
 
     verbose << "=> Pruning Automaton" << endl;
@@ -81,6 +142,10 @@ spot::twa_graph_ptr get_nba_for_synthesis(const spot::formula& formula,
     auto pruned_automaton = spot::scc_filter_states(automaton);  // Prune automaton
     synt_measures.end_prune_automaton(pruned_automaton);
 
+    if (nba_cache != nullptr && !nba_cache->store(nba_cache_key, pruned_automaton)) {
+        verbose << "=> Failed to store the pruned automaton in the NBA cache" << endl;
+    }
+
     return pruned_automaton;
 }
 
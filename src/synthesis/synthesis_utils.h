@@ -7,13 +7,17 @@
 #include <spot/twaalgos/degen.hh>
 #include <spot/twaalgos/determinize.hh>
 #include <spot/twaalgos/game.hh>
+#include <spot/twaalgos/determinize.hh>
 #include <spot/twaalgos/hoa.hh>
 #include <spot/twaalgos/isdet.hh>
 #include <spot/twaalgos/mealy_machine.hh>
+#include <spot/twaalgos/parity.hh>
 #include <spot/twaalgos/sbacc.hh>
 #include <spot/twaalgos/sccfilter.hh>
 #include <spot/twaalgos/synthesis.hh>
+#include <spot/twaalgos/toparity.hh>
 #include <spot/twaalgos/translate.hh>
+#include <spot/twaalgos/zlktree.hh>
 #include <vector>
 
 #include "find_deps_by_automaton.h"
@@ -24,18 +28,49 @@
 
 spot::twa_graph_ptr ntgba2dpa(const spot::twa_graph_ptr& aut, bool force_sbacc);
 
+#define ORIGINAL_CONDITIONS_PROP "original-conditions"
+
+/**
+ * @brief The conditions of the edges of an automaton (by edge number) before APs were
+ * removed from it. The removed APs stay registered by it, so its BDDs remain valid.
+ */
+struct OriginalConditions {
+    std::vector<bdd> conds;
+    spot::bdd_dict_ptr dict;
+
+    explicit OriginalConditions(const spot::bdd_dict_ptr& dict) : dict(dict) {}
+
+    ~OriginalConditions() { dict->unregister_all_my_variables(this); }
+};
+
+/**
+ * @brief Remove the variables from the conditions of the automaton's edges, in place.
+ * Each edge keeps its original condition as a second label, in the OriginalConditions
+ * of the ORIGINAL_CONDITIONS_PROP named property, so no copy of the automaton is needed.
+ */
 void remove_ap_from_automaton(const spot::twa_graph_ptr& automaton,
-                              std::vector<std::string>& variables,
-                              unordered_map<int, bdd>& bdd_to_bdd_without_deps);
+                              std::vector<std::string>& variables);
+
+// The OriginalConditions of an automaton whose APs were removed, throws if there are none
+const std::vector<bdd>& get_original_conditions(const spot::twa_graph_ptr& automaton);
 
+/**
+ * @brief Build the parity game of the NBA by the algorithm of gi.s: SPLIT_DET (split,
+ * then determinize), DET_SPLIT, LAR or ACD.
+ */
 spot::twa_graph_ptr get_dpa_from_nba(spot::twa_graph_ptr nba,
                                      spot::synthesis_info& gi,
                                      const std::vector<std::string>& output_vars);
 
-spot::twa_graph_ptr get_nba_for_synthesis(const spot::formula& formula,
+/**
+ * @brief Translate the instance's formula to a pruned NBA. If nba_cache_dir is not
+ * empty, the NBA is loaded from the NBACache in it when possible, and stored otherwise.
+ */
+spot::twa_graph_ptr get_nba_for_synthesis(SyntInstance& synt_instance,
                                           spot::synthesis_info& gi,
                                           BaseMeasures& synt_measures,
-                                          std::ostream& verbose);
+                                          std::ostream& verbose,
+                                          const std::string& nba_cache_dir = "");
 
 // Return if realizable
 bool synthesis_nba_to_mealy(spot::synthesis_info& gi, spot::twa_graph_ptr& automaton,
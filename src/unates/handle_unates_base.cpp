@@ -35,10 +35,13 @@ void HandleUnatesBase::handle_unate_in_state(unsigned state, int varnum, UnateTy
                    : bdd_nithvar(varnum);
 
     // Update the original automaton
-    for(auto& edge : m_automaton->out(state)) {
+    for(unsigned edge_idx = m_compact_nba.edges_begin(state); edge_idx < m_compact_nba.edges_end(state); edge_idx++) {
+        auto& edge = m_automaton->edge_storage(m_compact_nba.edge_num(edge_idx));
+
         // If variable is positive Unate, we transform the edge e: [∃x(e) ^ x] (Negative Unate is [∃x(e) ^ ~x])
         bdd cond_before = edge.cond;
         edge.cond = bdd_exist(edge.cond, bdd_ithvar(varnum)) & var_bdd;
+        m_compact_nba.set_edge_cond(edge_idx, edge.cond);
 
         bool is_impacted = edge.cond != cond_before;
         if(is_impacted) {
@@ -1,6 +1,7 @@
 #ifndef REACTIVE_SYNTHESIS_BFSS_HANDLE_UNATES_BASE_H
 #define REACTIVE_SYNTHESIS_BFSS_HANDLE_UNATES_BASE_H
 
+#include "compact_nba.h"
 #include "unate_utils.h"
 #include "synt_instance.h"
 
@@ -9,6 +10,8 @@ protected:
     spot::twa_graph_ptr m_automaton;
     SyntInstance& m_synt_instance;
     UnatesHandlerMeasures& m_unate_measures;
+    std::vector<int> m_var_nums;  // VarId -> BDD variable, -1 for input variables
+    CompactNBA m_compact_nba;     // Kept in sync with the conditions until the automaton is purged
 
 protected:
     virtual void resolve_unates_in_state(unsigned state) = 0;
@@ -16,9 +19,15 @@ protected:
     virtual void handle_unate_in_state(unsigned state, int varnum, UnateType unate_type, UnateEffectOnState& unate_effect_on_state);
 public:
     explicit HandleUnatesBase(const spot::twa_graph_ptr& automaton, SyntInstance& synt_instance, UnatesHandlerMeasures& unate_measures, const char* algo_name)
-    : m_synt_instance(synt_instance), m_unate_measures(unate_measures) {
+    : m_synt_instance(synt_instance), m_unate_measures(unate_measures), m_compact_nba(automaton) {
         m_automaton = automaton;
         m_unate_measures.set_algorithm_name(algo_name);
+
+        // Only the output variables are tested
+        m_var_nums.assign(m_synt_instance.get_total_vars(), -1);
+        for (VarId var : m_synt_instance.get_output_ids()) {
+            m_var_nums[var] = m_automaton->register_ap(m_synt_instance.get_var_name(var));
+        }
     }
 
     void run();
@@ -51,16 +51,17 @@ void HandleUnatesByComplement::resolve_unates_in_state(unsigned state) {
     m_unate_measures.end_automaton_complement();
 
     ////////////// Check for Unate in all variables
-    vector<string> untested_vars( m_synt_instance.get_output_vars() );
-    vector<string> not_unate_vars;
+    vector<VarId> untested_vars( m_synt_instance.get_output_ids() );
+    vector<VarId> not_unate_vars;
     UnateEffectOnState unate_effect_on_state;
 
     while(!untested_vars.empty()) {
-        string var = untested_vars.back();
+        VarId var = untested_vars.back();
         untested_vars.pop_back();
 
-        m_unate_measures.start_testing_var(var);
-        int varnum = m_automaton_clone->register_ap(var);
+        string var_name = m_synt_instance.get_var_name(var);
+        m_unate_measures.start_testing_var(var_name);
+        int varnum = m_var_nums[var];  // The clone shares the BDD dict of m_automaton
 
         if(is_var_unate_in_state(state, varnum, complement, UnateType::Positive)) {
             this->handle_unate_in_state(state, varnum, UnateType::Positive, unate_effect_on_state);
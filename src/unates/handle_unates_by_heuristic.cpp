@@ -12,10 +12,10 @@
 void HandleUnatesByHeuristic::resolve_unates_in_state(unsigned int state) {
     m_unate_measures.start_testing_state(state);
 
-    vector<string> untested_vars( m_synt_instance.get_output_vars() );
-    vector<string> not_positive_unate;
-    vector<string> not_negative_unate;
-    vector<string> unknown_unate;
+    vector<VarId> untested_vars( m_synt_instance.get_output_ids() );
+    vector<VarId> not_positive_unate;
+    vector<VarId> not_negative_unate;
+    vector<VarId> unknown_unate;
     UnateEffectOnState unate_effect_on_state;
 
     auto test_unknown = [&]() {
@@ -24,11 +24,12 @@ void HandleUnatesByHeuristic::resolve_unates_in_state(unsigned int state) {
     };
 
     while(!untested_vars.empty()) {
-        string var = untested_vars.back();
+        VarId var = untested_vars.back();
         untested_vars.pop_back();
 
-        m_unate_measures.start_testing_var(var);
-        int varnum = m_automaton->register_ap(var);
+        string var_name = m_synt_instance.get_var_name(var);
+        m_unate_measures.start_testing_var(var_name);
+        int varnum = m_var_nums[var];
 
         bdd var_positive = bdd_ithvar(varnum);
         bdd var_negative = bdd_nithvar(varnum);
@@ -38,9 +39,10 @@ void HandleUnatesByHeuristic::resolve_unates_in_state(unsigned int state) {
         bdd positive_edges_condition = bddfalse;
         bdd negative_edges_condition = bddfalse;
 
-        for(auto& edge : m_automaton->out(state)) {
-            bdd edge_positive = bdd_restrict(edge.cond, var_positive);
-            bdd edge_negative = bdd_restrict(edge.cond, var_negative);
+        for(unsigned edge = m_compact_nba.edges_begin(state); edge < m_compact_nba.edges_end(state); edge++) {
+            const bdd& edge_cond = m_compact_nba.edge_cond(edge);
+            bdd edge_positive = bdd_restrict(edge_cond, var_positive);
+            bdd edge_negative = bdd_restrict(edge_cond, var_negative);
 
             positive_unate_sufficient_condition &= bdd_imp(edge_negative, edge_positive);
             negative_unate_sufficient_condition &= bdd_imp(edge_positive, edge_negative);
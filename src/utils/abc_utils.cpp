@@ -1,30 +1,177 @@
+#include <sys/mman.h>
+#include <unistd.h>
+
 #include <cstdio>
+#include <cstdlib>
+#include <boost/algorithm/string/trim.hpp>
 #include "abc_utils.h"
 
-int blif_file_to_binary_aig_file(std::string& blifFile, std::string& aigerFile) {
-    Abc_Frame_t * pAbc;
-    Abc_Start();
-    pAbc = Abc_FrameGetGlobalFrame();
+// The size of the network of ABC, read from memory
+static int count_gates(Abc_Frame_t * pAbc) {
+    Abc_Ntk_t * pNtk = Abc_FrameReadNtk( pAbc );
+    return pNtk == NULL ? -1 : Abc_NtkNodeNum( pNtk );
+}
 
-    if ( Cmd_CommandExecute( pAbc, ("read " + blifFile).c_str() ) )
+// Write the network of ABC to the AIGER file, only structurally hashed networks are written
+static bool write_aiger(Abc_Frame_t * pAbc, const std::string& aigerFile) {
+    remove( aigerFile.c_str() );
+    if ( Cmd_CommandExecute( pAbc, ("write " + aigerFile).c_str() ) )
     {
-        fprintf( stdout, "Cannot read blif path %s", blifFile.c_str() );
-        return EXIT_FAILURE;
+        return false;
     }
+    return access( aigerFile.c_str(), F_OK ) == 0;
+}
 
-    // Make the circle smaller
-    Cmd_CommandExecute( pAbc, "strash" );
-    Cmd_CommandExecute( pAbc, "rewrite" ); Cmd_CommandExecute( pAbc, "balance" ); Cmd_CommandExecute( pAbc, "refactor" );
-    Cmd_CommandExecute( pAbc, "rewrite" ); Cmd_CommandExecute( pAbc, "balance" ); Cmd_CommandExecute( pAbc, "refactor" );
-    Cmd_CommandExecute( pAbc, "rewrite" ); Cmd_CommandExecute( pAbc, "balance" ); Cmd_CommandExecute( pAbc, "refactor" );
+static bool run_pass(Abc_Frame_t * pAbc, const std::string& command, std::vector<AbcPass>& passes) {
+    TimeMeasure pass_time;
+    pass_time.start();
+    if ( Cmd_CommandExecute( pAbc, command.c_str() ) )
+    {
+        fprintf( stdout, "ABC command failed: %s\n", command.c_str() );
+        return false;
+    }
+    Duration duration = pass_time.end();
 
-    // Write the AIGER file
-    if ( Cmd_CommandExecute( pAbc, ("write " + aigerFile).c_str() ) )
+    passes.push_back({command, count_gates(pAbc), duration});
+    return true;
+}
+
+static bool run_script(Abc_Frame_t * pAbc, const std::string& script, std::vector<AbcPass>& passes) {
+    size_t begin = 0;
+    while ( begin <= script.size() )
     {
-        fprintf( stdout, "Cannot write AIGER path %s", aigerFile.c_str() );
-        return EXIT_FAILURE;
+        size_t end = script.find(';', begin);
+        if ( end == std::string::npos )
+        {
+            end = script.size();
+        }
+        std::string command = boost::algorithm::trim_copy(script.substr(begin, end - begin));
+        if ( !command.empty() && !run_pass(pAbc, command, passes) )
+        {
+            return false;
+        }
+        begin = end + 1;
     }
+    return true;
+}
 
+// Rounds of optimizations until a round doesn't shrink the circuit enough, the smallest
+// circuit is kept in the AIGER file
+static bool run_adaptive_script(Abc_Frame_t * pAbc, const std::string& aigerFile,
+                                Duration time_budget, std::vector<AbcPass>& passes) {
+    TimeMeasure total_time;
+    total_time.start();
+    if ( !run_pass(pAbc, "strash", passes) || passes.back().gates < 0 ||
+         !write_aiger(pAbc, aigerFile) )
+    {
+        return false;
+    }
+
+    int best_gates = passes.back().gates;
+    while ( best_gates > 0 && (time_budget <= 0 || total_time.time_elapsed() < time_budget) )
+    {
+        const char * round = best_gates <= ABC_ADAPTIVE_SMALL_CIRCUIT
+                                 ? "dc2"
+                                 : "rewrite; balance; refactor";
+        if ( !run_script(pAbc, round, passes) || passes.back().gates < 0 )
+        {
+            break;
+        }
+
+        int gates = passes.back().gates;
+        bool is_improved = gates < best_gates;
+        bool is_improved_enough = best_gates - gates >= ABC_ADAPTIVE_MIN_IMPROVEMENT * best_gates;
+        if ( is_improved )
+        {
+            if ( !write_aiger(pAbc, aigerFile) )
+            {
+                return false;
+            }
+            best_gates = gates;
+        }
+        if ( !is_improved_enough )
+        {
+            break;
+        }
+    }
+
+    return true;
+}
+
+AbcSession::AbcSession() {
+    Abc_Start();
+    m_frame = Abc_FrameGetGlobalFrame();
+}
+
+AbcSession::~AbcSession() {
     Abc_Stop();
-    return EXIT_SUCCESS;
+}
+
+AbcSession_ptr AbcSession::get() {
+    static std::weak_ptr<AbcSession> process_session;
+
+    AbcSession_ptr session = process_session.lock();
+    if ( session == nullptr )
+    {
+        session = AbcSession_ptr(new AbcSession());
+        process_session = session;
+    }
+    return session;
+}
+
+bool AbcSession::read_blif(const std::string& blif) {
+    // ABC reads files by path, an anonymous memory-backed file has one in /proc
+    int fd = memfd_create( "abc_blif", 0 );
+    if ( fd < 0 )
+    {
+        fprintf( stdout, "Cannot create a memory file for the blif" );
+        return false;
+    }
+
+    size_t total_written = 0;
+    while ( total_written < blif.size() )
+    {
+        ssize_t written = write( fd, blif.data() + total_written, blif.size() - total_written );
+        if ( written < 0 )
+        {
+            close( fd );
+            fprintf( stdout, "Cannot write the blif to a memory file" );
+            return false;
+        }
+        total_written += written;
+    }
+
+    std::string blif_path = "/proc/self/fd/" + std::to_string(fd);
+    bool is_read = Cmd_CommandExecute( m_frame, ("read_blif " + blif_path).c_str() ) == 0;
+    close( fd );
+    if ( !is_read )
+    {
+        fprintf( stdout, "Cannot read blif path %s", blif_path.c_str() );
+    }
+    return is_read;
+}
+
+bool AbcSession::optimize(const std::string& script, Duration time_budget,
+                          const std::string& aigerFile, std::vector<AbcPass>& passes) {
+    // Make the circle smaller, the sizes of the passes are read from ABC's network
+    bool is_optimized;
+    if ( script == ABC_ADAPTIVE_SCRIPT )
+    {
+        is_optimized = run_adaptive_script(m_frame, aigerFile, time_budget, passes);
+    }
+    else
+    {
+        is_optimized = run_script(m_frame, script, passes);
+
+        // Only structurally hashed networks can be written as AIGER
+        if ( is_optimized && !write_aiger(m_frame, aigerFile) )
+        {
+            is_optimized = run_pass(m_frame, "strash", passes) && write_aiger(m_frame, aigerFile);
+        }
+    }
+    if ( !is_optimized )
+    {
+        fprintf( stdout, "Cannot write AIGER path %s", aigerFile.c_str() );
+    }
+    return is_optimized;
 }
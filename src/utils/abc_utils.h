@@ -1,4 +1,11 @@
+#ifndef REACTIVE_SYNTHESIS_ABC_UTILS_H
+#define REACTIVE_SYNTHESIS_ABC_UTILS_H
+
+#include <memory>
 #include <string>
+#include <vector>
+
+#include "utils.h"
 
 #if defined(ABC_NAMESPACE)
 namespace ABC_NAMESPACE
@@ -19,6 +26,23 @@ typedef struct Abc_Frame_t_ Abc_Frame_t;
 Abc_Frame_t * Abc_FrameGetGlobalFrame();
 int    Cmd_CommandExecute( Abc_Frame_t * pAbc, const char * sCommand );
 
+// procedures to read the current network of the framework (base/abc/abc.h), its nodes
+// are the AND gates once it is structurally hashed
+typedef struct Abc_Ntk_t_ Abc_Ntk_t;
+
+Abc_Ntk_t * Abc_FrameReadNtk( Abc_Frame_t * p );
+int    Abc_NtkNodeNum( Abc_Ntk_t * pNtk );
+
+// procedures of ABC's SAT solver (sat/bsat/satSolver.h), a literal is 2*var+sign
+typedef struct sat_solver_t sat_solver;
+
+sat_solver * sat_solver_new();
+void   sat_solver_delete( sat_solver * s );
+void   sat_solver_setnvars( sat_solver * s, int n );
+int    sat_solver_addclause( sat_solver * s, int * begin, int * end );
+int    sat_solver_solve( sat_solver * s, int * begin, int * end, long long nConfLimit,
+                         long long nInsLimit, long long nConfLimitGlobal, long long nInsLimitGlobal );
+
 #if defined(ABC_NAMESPACE)
 }
 using namespace ABC_NAMESPACE;
@@ -26,4 +50,72 @@ using namespace ABC_NAMESPACE;
 }
 #endif
 
-int blif_file_to_binary_aig_file(std::string& blifFile, std::string& aigerFile);
\ No newline at end of file
+// Results of sat_solver_solve
+#define ABC_SAT_TRUE 1
+#define ABC_SAT_FALSE -1
+
+// The script of the optimization of the strategies before this was configurable
+#define ABC_DEFAULT_SCRIPT                                                             \
+    "strash; rewrite; balance; refactor; rewrite; balance; refactor; rewrite; balance; " \
+    "refactor"
+
+// Instead of a script, repeat rounds of optimizations while they shrink the circuit
+#define ABC_ADAPTIVE_SCRIPT "adaptive"
+
+// Skip the optimization of the strategies by ABC
+#define ABC_SKIP_SCRIPT "none"
+
+// A round of the adaptive script shrinks the circuit by at least this ratio, or it stops
+#define ABC_ADAPTIVE_MIN_IMPROVEMENT 0.01
+
+// Circuits up to this number of gates get the heavier rounds of the adaptive script
+#define ABC_ADAPTIVE_SMALL_CIRCUIT 5000
+
+// A command of an ABC script, gates is the number of nodes of the network after it (the
+// AND gates once it is structurally hashed, -1 if unknown)
+struct AbcPass {
+    std::string command;
+    int gates;
+    Duration duration;
+};
+
+class AbcSession;
+using AbcSession_ptr = std::shared_ptr<AbcSession>;
+
+/**
+ * @brief The ABC framework of the process, started once and shared by its users.
+ * ABC is stopped when the last user releases the session. A process forked while the
+ * session is held inherits the started framework.
+ */
+class AbcSession {
+private:
+    Abc_Frame_t * m_frame;
+
+    AbcSession();
+
+public:
+    ~AbcSession();
+
+    AbcSession(const AbcSession&) = delete;
+    AbcSession& operator=(const AbcSession&) = delete;
+
+    // The session of the process, ABC is started if no one holds it
+    static AbcSession_ptr get();
+
+    /**
+     * @brief Load a BLIF network into the framework from memory.
+     */
+    bool read_blif(const std::string& blif);
+
+    /**
+     * @brief Optimize the loaded network and write it as a binary AIGER file. The file is
+     * written once, the adaptive script rewrites it for each smaller circuit it finds.
+     * @param script ABC commands separated by ';', or ABC_ADAPTIVE_SCRIPT
+     * @param time_budget Time budget of the adaptive script in milliseconds, unlimited if 0
+     * @param passes The commands that ran, with the circuit size and time of each
+     */
+    bool optimize(const std::string& script, Duration time_budget,
+                  const std::string& aigerFile, std::vector<AbcPass>& passes);
+};
+
+#endif  // REACTIVE_SYNTHESIS_ABC_UTILS_H
@@ -0,0 +1,250 @@
+#include "batch_runner.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <nlohmann/json.hpp>
+#include <stdexcept>
+
+#define BATCH_RUNNER_KILL_GRACE_MS 1000
+
+using json = nlohmann::json;
+
+static std::string trim(const std::string& str) {
+    size_t begin = str.find_first_not_of(" \t\r");
+    if (begin == std::string::npos) {
+        return "";
+    }
+    size_t end = str.find_last_not_of(" \t\r");
+    return str.substr(begin, end - begin + 1);
+}
+
+// A JSON list of variables is joined by commas, as in the CLI
+static std::string json_to_variables(const json& value) {
+    if (!value.is_array()) {
+        return value.get<std::string>();
+    }
+
+    std::string variables;
+    for (auto& var : value) {
+        variables += (variables.empty() ? "" : ",") + var.get<std::string>();
+    }
+    return variables;
+}
+
+static void read_jsonl_specs(std::istream& in, std::vector<BatchSpec>& specs) {
+    std::string line;
+    while (std::getline(in, line)) {
+        if (trim(line).empty()) {
+            continue;
+        }
+
+        json obj = json::parse(line);
+        BatchSpec spec;
+        spec.name = obj.value("name", "");
+        spec.family = obj.value("family", "");
+        spec.formula = obj.value("formula", "");
+        if (obj.contains("input")) {
+            spec.inputs = json_to_variables(obj["input"]);
+        }
+        if (obj.contains("output")) {
+            spec.outputs = json_to_variables(obj["output"]);
+        }
+        specs.push_back(spec);
+    }
+}
+
+static void read_text_specs(std::istream& in, std::vector<BatchSpec>& specs) {
+    std::string line;
+    while (std::getline(in, line)) {
+        size_t colon = line.find(':');
+        if (colon == std::string::npos) {
+            continue;
+        }
+        std::string key = trim(line.substr(0, colon));
+        std::string value = trim(line.substr(colon + 1));
+
+        if (key == "Name" || specs.empty()) {
+            specs.emplace_back();
+        }
+        BatchSpec& spec = specs.back();
+        if (key == "Name") {
+            spec.name = value;
+        } else if (key == "Family") {
+            spec.family = value;
+        } else if (key == "Formula") {
+            spec.formula = value;
+        } else if (key == "Input") {
+            spec.inputs = value;
+        } else if (key == "Output") {
+            spec.outputs = value;
+        }
+    }
+}
+
+void read_batch_specs(const std::string& path, std::vector<BatchSpec>& specs) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("Can't read the batch file: " + path);
+    }
+
+    char first_char = ' ';
+    while (in.get(first_char) && std::isspace(static_cast<unsigned char>(first_char))) {
+    }
+    in.unget();
+
+    try {
+        if (first_char == '{') {
+            read_jsonl_specs(in, specs);
+        } else {
+            read_text_specs(in, specs);
+        }
+    } catch (const json::exception& ex) {
+        throw std::runtime_error("Invalid batch file " + path + ": " + ex.what());
+    }
+
+    for (size_t i = 0; i < specs.size(); i++) {
+        if (specs[i].formula.empty()) {
+            throw std::runtime_error("The specification " + std::to_string(i + 1) +
+                                     " of the batch has no formula");
+        }
+        if (specs[i].name.empty()) {
+            specs[i].name = "spec" + std::to_string(i + 1);
+        }
+    }
+}
+
+void BatchRunner::dump_failure(const BatchSpec& spec, const std::string& reason,
+                               Duration duration, BaseCLIOptions& cli_options) const {
+    std::vector<std::string> input_vars, output_vars;
+    extract_variables(spec.inputs, input_vars);
+    extract_variables(spec.outputs, output_vars);
+
+    json obj;
+    obj["model_name"] = spec.name;
+    obj["is_completed"] = false;
+    obj["batch_failure"] = reason;
+    obj["output_vars"] = output_vars;
+    obj["input_vars"] = input_vars;
+    obj["formula"] = spec.formula;
+    obj["total_time"] = duration;
+
+    if (cli_options.measures_path.empty()) {
+        std::cout << obj << std::endl;
+        return;
+    }
+    std::ofstream measure_file(cli_options.measures_path, std::ios::app);
+    measure_file << obj << std::endl;
+}
+
+unsigned BatchRunner::run(const std::vector<BatchSpec>& specs,
+                          const std::function<int(const BatchSpec&)>& synthesize,
+                          BaseCLIOptions& cli_options) const {
+    if (!cli_options.measures_path.empty()) {
+        std::ofstream measure_file(cli_options.measures_path, std::ios::trunc);
+    }
+    cli_options.append_measures = true;
+
+    unsigned total_failures = 0;
+    for (auto& spec : specs) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            throw std::runtime_error("Can't create a pipe for the batch");
+        }
+
+        // Otherwise the buffered output is written by both processes
+        std::cout.flush();
+        std::cerr.flush();
+
+        TimeMeasure spec_time;
+        spec_time.start();
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            throw std::runtime_error("Can't fork a process for the batch");
+        }
+
+        if (pid == 0) {
+            // Specification process, its own group so its workers are killed with it.
+            // The write end of the pipe is closed when they all exit.
+            close(fds[0]);
+            setpgid(0, 0);
+            if (m_spec_memory_limit > 0) {
+                rlimit limit;
+                limit.rlim_cur = limit.rlim_max = static_cast<rlim_t>(m_spec_memory_limit)
+                                                  << 20;
+                setrlimit(RLIMIT_AS, &limit);
+            }
+
+            int exit_code = synthesize(spec);
+            std::cout.flush();
+            std::cerr.flush();
+            _exit(exit_code);
+        }
+
+        close(fds[1]);
+        setpgid(pid, pid);
+
+        bool is_terminated = false;
+        Duration deadline = m_spec_timeout;
+        pollfd exit_pipe = {fds[0], POLLIN, 0};
+        while (true) {
+            int poll_timeout = -1;
+            if (m_spec_timeout > 0) {
+                poll_timeout = static_cast<int>(
+                    std::max<Duration>(0, deadline - spec_time.time_elapsed()));
+            }
+
+            int ready = poll(&exit_pipe, 1, poll_timeout);
+            if (ready < 0 && errno == EINTR) {
+                continue;
+            }
+            if (ready < 0) {
+                // The process can't be watched, so its timeout can't be enforced
+                kill(-pid, SIGKILL);
+                break;
+            }
+            if (ready != 0) {
+                break;  // The process exited (nothing is written to the pipe)
+            }
+
+            if (!is_terminated) {
+                // Only the specification process dumps its measures, its workers are
+                // killed with the group after the grace period
+                kill(pid, SIGTERM);
+                is_terminated = true;
+                deadline += BATCH_RUNNER_KILL_GRACE_MS;
+            } else {
+                kill(-pid, SIGKILL);
+                break;
+            }
+        }
+        close(fds[0]);
+
+        int status = 0;
+        while (waitpid(pid, &status, 0) < 0 && errno == EINTR) {
+        }
+
+        if (is_terminated || !WIFEXITED(status)) {
+            total_failures++;
+        }
+        if (!WIFEXITED(status)) {
+            std::string reason = is_terminated
+                                     ? "timeout"
+                                     : "killed by signal " + std::to_string(WTERMSIG(status));
+            dump_failure(spec, reason, spec_time.time_elapsed(), cli_options);
+        }
+    }
+
+    return total_failures;
+}
@@ -0,0 +1,61 @@
+#ifndef BATCH_RUNNER_H
+#define BATCH_RUNNER_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+// A specification of a batch, as in the benchmarks-ltl files
+struct BatchSpec {
+    std::string name;
+    std::string family;
+    std::string formula;
+    std::string inputs;
+    std::string outputs;
+};
+
+/**
+ * @brief Read the specifications of a batch file. It is either JSONL, an object per
+ * line with the keys name, family, formula, input and output, or the benchmarks-ltl
+ * text format (Name, Family, Formula, Input and Output lines), where a Name line starts
+ * a new specification, so the benchmark files can be concatenated.
+ * Throws runtime_error if the file can't be read or a specification has no formula.
+ */
+void read_batch_specs(const std::string& path, std::vector<BatchSpec>& specs);
+
+/**
+ * @brief Run the specifications of a batch one after the other, each in a forked
+ * process. The process inherits the initialized libraries (e.g., BuDDy's tables) of
+ * the batch, so a specification doesn't pay for the process startup, and the time and
+ * memory budgets of a specification are enforced without affecting the others.
+ *
+ * When the time budget is over, the process gets SIGTERM (so it can dump its measures),
+ * and its process group (with its workers) gets SIGKILL after a grace period. If the process didn't exit normally, a measures
+ * record of the failure is written instead.
+ */
+class BatchRunner {
+   private:
+    Duration m_spec_timeout;        // Milliseconds, unlimited if 0
+    unsigned m_spec_memory_limit;   // MB of address space, unlimited if 0
+
+    void dump_failure(const BatchSpec& spec, const std::string& reason, Duration duration,
+                      BaseCLIOptions& cli_options) const;
+
+   public:
+    BatchRunner(Duration spec_timeout, unsigned spec_memory_limit)
+        : m_spec_timeout(spec_timeout), m_spec_memory_limit(spec_memory_limit) {}
+
+    /**
+     * @brief Run synthesize(spec) for each specification in a forked process, its
+     * return value is the exit code of the process. The measures of all the
+     * specifications are appended to cli_options.measures_path (truncated first).
+     * Return the number of specifications whose process failed.
+     */
+    unsigned run(const std::vector<BatchSpec>& specs,
+                 const std::function<int(const BatchSpec&)>& synthesize,
+                 BaseCLIOptions& cli_options) const;
+};
+
+#endif
@@ -3,34 +3,69 @@
 #include <spot/tl/parse.hh>
 #include <spot/twaalgos/translate.hh>
 
-BDDVarsCacher::BDDVarsCacher(spot::twa_graph_ptr automaton)
-    : m_automaton(automaton), m_prime_var_coefficient(0) {
-    m_total_vars = automaton->ap().size();
-
-    // Register prime variables
-    m_prime_var_start =
-        automaton->get_dict()->register_anonymous_variables(m_total_vars, automaton);
+// A prime name which is a variable of the instance can't be used for its prime
+static bool can_interleave_prime_vars(SyntInstance& synt_instance) {
+    for (VarId var = 0; var < synt_instance.get_total_vars(); var++) {
+        if (synt_instance.has_var(get_prime_variable(synt_instance.get_var_name(var)))) {
+            return false;
+        }
+    }
+    return true;
 }
 
-int BDDVarsCacher::get_variable_index(std::string& variable_name) {
-    if (m_variable_index.find(variable_name) == m_variable_index.end()) {
-        m_variable_index[variable_name] = m_automaton->register_ap(variable_name);
+InterleavedPrimeVars::InterleavedPrimeVars(const spot::bdd_dict_ptr& dict,
+                                           SyntInstance& synt_instance)
+    : m_dict(dict) {
+    if (!can_interleave_prime_vars(synt_instance)) {
+        return;
     }
 
-    return m_variable_index[variable_name];
+    for (VarId var = 0; var < synt_instance.get_total_vars(); var++) {
+        const std::string& var_name = synt_instance.get_var_name(var);
+        m_dict->register_proposition(spot::formula::ap(var_name), this);
+        m_dict->register_proposition(spot::formula::ap(get_prime_variable(var_name)),
+                                     this);
+    }
 }
 
-int BDDVarsCacher::get_prime_variable_index(std::string& variable_name) {
-    if (m_prime_variable_index.find(variable_name) == m_prime_variable_index.end()) {
-        m_prime_variable_index[variable_name] =
-            m_prime_var_start + m_prime_var_coefficient;
+BDDVarsCacher::BDDVarsCacher(spot::twa_graph_ptr automaton, SyntInstance& synt_instance)
+    : m_is_interleaved(false), m_automaton(automaton) {
+    size_t total_vars = synt_instance.get_total_vars();
+    const spot::bdd_dict_ptr& dict = m_automaton->get_dict();
 
-        m_prime_var_coefficient++;
+    for (VarId var = 0; var < total_vars; var++) {
+        m_variable_index.push_back(m_automaton->register_ap(synt_instance.get_var_name(var)));
     }
 
-    return m_prime_variable_index[variable_name];
+    // Use the prime variables reserved by InterleavedPrimeVars, if there are any
+    m_is_interleaved = total_vars > 0 && can_interleave_prime_vars(synt_instance);
+    for (VarId var = 0; var < total_vars && m_is_interleaved; var++) {
+        spot::formula prime_ap =
+            spot::formula::ap(get_prime_variable(synt_instance.get_var_name(var)));
+        m_is_interleaved = dict->var_map.find(prime_ap) != dict->var_map.end();
+    }
+
+    if (m_is_interleaved) {
+        for (VarId var = 0; var < total_vars; var++) {
+            spot::formula prime_ap =
+                spot::formula::ap(get_prime_variable(synt_instance.get_var_name(var)));
+            m_prime_variable_index.push_back(
+                dict->register_proposition(prime_ap, m_automaton));
+        }
+    } else {
+        int prime_var_start =
+            dict->register_anonymous_variables(static_cast<int>(total_vars), m_automaton);
+        for (VarId var = 0; var < total_vars; var++) {
+            m_prime_variable_index.push_back(prime_var_start + static_cast<int>(var));
+        }
+    }
 }
 
+long get_bdd_produced_nodes() {
+    bddStat stat;
+    bdd_stats(stat);
+    return stat.produced;
+}
 
 bool can_restrict_variable(bdd& bd, int variable, bool restriction_value) {
     bdd var_bdd = restriction_value ? bdd_ithvar(variable) : bdd_nithvar(variable);
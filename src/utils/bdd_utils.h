@@ -7,21 +7,50 @@
 #include <string>
 #include <vector>
 
+#include "synt_instance.h"
+
+/**
+ * @brief Reserve in the dictionary each variable of the instance, directly followed by
+ * its prime variable, so x and x' are adjacent in the BDD order. It has to be created
+ * before the automaton is translated, since BuDDy orders the variables by their
+ * allocation. BDDVarsCacher then uses these prime variables. The variables are released
+ * on destruction.
+ */
+class InterleavedPrimeVars {
+   private:
+    spot::bdd_dict_ptr m_dict;
+
+   public:
+    InterleavedPrimeVars(const spot::bdd_dict_ptr& dict, SyntInstance& synt_instance);
+
+    InterleavedPrimeVars(const InterleavedPrimeVars&) = delete;
+    InterleavedPrimeVars& operator=(const InterleavedPrimeVars&) = delete;
+
+    ~InterleavedPrimeVars() { m_dict->unregister_all_my_variables(this); }
+};
+
+/**
+ * @brief Map the variables of a SyntInstance (by their ids) to the BDD variables of
+ * the automaton, and to their prime BDD variables. The mapping is computed once.
+ *
+ * If the prime variables were reserved by InterleavedPrimeVars they are used,
+ * otherwise they are registered as a single block after all the other variables.
+ */
 class BDDVarsCacher {
    private:
-    int m_total_vars;
-    int m_prime_var_start;  // At what index of variable, the prime var starts
-    int m_prime_var_coefficient;
-    std::unordered_map<std::string, int> m_variable_index;
-    std::unordered_map<std::string, int> m_prime_variable_index;
+    bool m_is_interleaved;
+    std::vector<int> m_variable_index;
+    std::vector<int> m_prime_variable_index;
     spot::twa_graph_ptr m_automaton;
 
    public:
-    BDDVarsCacher(spot::twa_graph_ptr automaton);
+    BDDVarsCacher(spot::twa_graph_ptr automaton, SyntInstance& synt_instance);
 
-    int get_variable_index(std::string& variable_name);
+    int get_variable_index(VarId var) const { return m_variable_index[var]; }
 
-    int get_prime_variable_index(std::string& variable_name);
+    int get_prime_variable_index(VarId var) const { return m_prime_variable_index[var]; }
+
+    bool is_interleaved() const { return m_is_interleaved; }
 };
 
 struct NBABDDSummary {
@@ -35,6 +64,9 @@ struct NBABDDSummary {
 
 void extract_nba_bdd_summary(NBABDDSummary& summary, spot::twa_graph_ptr& nba);
 
+// Total number of BDD nodes BuDDy has produced so far
+long get_bdd_produced_nodes();
+
 /* Due to bug in BuDDY where restricting variable is not working if this is the only
  * variable left, this workaround is used. */
 bool can_restrict_variable(bdd& bd, int variable, bool restriction_value);
@@ -0,0 +1,29 @@
+#include "compact_nba.h"
+
+CompactNBA::CompactNBA(const spot::twa_graph_ptr& automaton) {
+    unsigned total_states = automaton->num_states();
+    m_offsets.reserve(total_states + 1);
+
+    for (unsigned state = 0; state < total_states; state++) {
+        m_offsets.push_back(static_cast<unsigned>(m_dsts.size()));
+
+        for (auto& edge : automaton->out(state)) {
+            m_dsts.push_back(edge.dst);
+            m_cond_ids.push_back(get_cond_id(edge.cond));
+            m_edge_nums.push_back(automaton->edge_number(edge));
+        }
+    }
+    m_offsets.push_back(static_cast<unsigned>(m_dsts.size()));
+}
+
+unsigned CompactNBA::get_cond_id(const bdd& cond) {
+    auto cond_it = m_cond_index.find(cond.id());
+    if (cond_it != m_cond_index.end()) {
+        return cond_it->second;
+    }
+
+    unsigned cond_id = static_cast<unsigned>(m_conds.size());
+    m_conds.push_back(cond);
+    m_cond_index.emplace(cond.id(), cond_id);
+    return cond_id;
+}
@@ -0,0 +1,56 @@
+#ifndef COMPACT_NBA_H
+#define COMPACT_NBA_H
+
+#include <spot/twa/twagraph.hh>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Snapshot of the NBA's edges in contiguous arrays, to avoid walking spot's
+ * linked edge storage again and again.
+ *
+ * The edges of state s are [edges_begin(s), edges_end(s)), in the same order as
+ * automaton->out(s). Each edge refers to its condition by a dense index into a table
+ * of the distinct conditions, so per-condition results can be cached in vectors.
+ * The structure (states, edges, destinations) is fixed, only the conditions of the
+ * edges can be updated; it must be built again if states or edges are changed.
+ */
+class CompactNBA {
+   private:
+    std::vector<unsigned> m_offsets;    // State -> index of its first edge
+    std::vector<unsigned> m_dsts;       // Edge -> destination
+    std::vector<unsigned> m_cond_ids;   // Edge -> index of its condition
+    std::vector<unsigned> m_edge_nums;  // Edge -> edge number in the automaton
+    std::vector<bdd> m_conds;           // Distinct conditions
+    std::unordered_map<int, unsigned> m_cond_index;  // BDD id -> index of condition
+
+    unsigned get_cond_id(const bdd& cond);
+
+   public:
+    explicit CompactNBA(const spot::twa_graph_ptr& automaton);
+
+    unsigned num_states() const { return static_cast<unsigned>(m_offsets.size()) - 1; }
+
+    unsigned num_edges() const { return static_cast<unsigned>(m_dsts.size()); }
+
+    unsigned num_conds() const { return static_cast<unsigned>(m_conds.size()); }
+
+    unsigned edges_begin(unsigned state) const { return m_offsets[state]; }
+
+    unsigned edges_end(unsigned state) const { return m_offsets[state + 1]; }
+
+    unsigned edge_dst(unsigned edge) const { return m_dsts[edge]; }
+
+    unsigned edge_cond_id(unsigned edge) const { return m_cond_ids[edge]; }
+
+    const bdd& edge_cond(unsigned edge) const { return m_conds[m_cond_ids[edge]]; }
+
+    unsigned edge_num(unsigned edge) const { return m_edge_nums[edge]; }
+
+    const bdd& cond(unsigned cond_id) const { return m_conds[cond_id]; }
+
+    // Update the condition of the edge in the snapshot only
+    void set_edge_cond(unsigned edge, const bdd& cond) { m_cond_ids[edge] = get_cond_id(cond); }
+};
+
+#endif
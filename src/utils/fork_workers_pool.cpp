@@ -0,0 +1,124 @@
+#include "fork_workers_pool.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+
+#define FORK_WORKERS_POOL_POLL_TIMEOUT_MS 20
+
+struct TaskResult {
+    uint32_t task;
+    uint32_t result;
+};
+
+static void write_result(int fd, const TaskResult& task_result) {
+    // A single record is smaller than PIPE_BUF, so the write is atomic
+    while (write(fd, &task_result, sizeof(task_result)) < 0 && errno == EINTR) {
+    }
+}
+
+bool ForkWorkersPool::run(size_t total_tasks, const std::function<bool(size_t)>& task,
+                          std::vector<int8_t>& results) {
+    results.assign(total_tasks, UNKNOWN_RESULT);
+    unsigned total_workers =
+        static_cast<unsigned>(std::min<size_t>(m_total_workers, total_tasks));
+
+    std::vector<pid_t> workers;
+    std::vector<int> pipes;
+
+    for (unsigned worker = 0; worker < total_workers; worker++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            break;
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            break;
+        }
+
+        if (pid == 0) {
+            // Worker process, never returns to the caller. A signal to the group must not
+            // run the parent's handlers (e.g. dumping the measures) in the worker.
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGINT, SIG_DFL);
+            signal(SIGHUP, SIG_DFL);
+            close(fds[0]);
+            for (int fd : pipes) {
+                close(fd);
+            }
+
+            try {
+                for (size_t i = worker; i < total_tasks; i += total_workers) {
+                    TaskResult task_result = {static_cast<uint32_t>(i),
+                                              task(i) ? 1u : 0u};
+                    write_result(fds[1], task_result);
+                }
+            } catch (...) {
+                // The unreported tasks are left as UNKNOWN_RESULT
+                _exit(EXIT_FAILURE);
+            }
+            close(fds[1]);
+            _exit(EXIT_SUCCESS);
+        }
+
+        close(fds[1]);
+        workers.push_back(pid);
+        pipes.push_back(fds[0]);
+    }
+
+    // Collect the results until all the workers closed their pipes
+    std::vector<pollfd> open_pipes;
+    for (int fd : pipes) {
+        open_pipes.push_back({fd, POLLIN, 0});
+    }
+
+    while (!open_pipes.empty() && !m_stop_flag.load()) {
+        int ready = poll(open_pipes.data(), open_pipes.size(),
+                         FORK_WORKERS_POOL_POLL_TIMEOUT_MS);
+        if (ready < 0 && errno != EINTR) {
+            break;
+        }
+
+        for (size_t i = 0; i < open_pipes.size();) {
+            if (open_pipes[i].revents == 0) {
+                i++;
+                continue;
+            }
+
+            TaskResult task_result;
+            ssize_t total_read = read(open_pipes[i].fd, &task_result, sizeof(task_result));
+            if (total_read == sizeof(task_result)) {
+                results[task_result.task] = static_cast<int8_t>(task_result.result);
+                i++;
+            } else if (total_read < 0 && errno == EINTR) {
+                i++;
+            } else {
+                // EOF (or a broken record), the worker is done
+                close(open_pipes[i].fd);
+                open_pipes.erase(open_pipes.begin() + i);
+            }
+        }
+    }
+
+    // Pipes are left open after a stop or a poll error, their workers may never end
+    bool should_kill = m_stop_flag.load() || !open_pipes.empty();
+    for (auto& open_pipe : open_pipes) {
+        close(open_pipe.fd);
+    }
+    for (pid_t pid : workers) {
+        if (should_kill) {
+            kill(pid, SIGKILL);
+        }
+        waitpid(pid, nullptr, 0);
+    }
+
+    return std::none_of(results.begin(), results.end(),
+                        [](int8_t result) { return result == UNKNOWN_RESULT; });
+}
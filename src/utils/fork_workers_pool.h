@@ -0,0 +1,38 @@
+#ifndef FORK_WORKERS_POOL_H
+#define FORK_WORKERS_POOL_H
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+/**
+ * @brief Run independent boolean tasks in forked worker processes.
+ *
+ * BuDDy is a global, single-threaded library, so BDD work can't be split between
+ * threads. Instead, each worker is a fork of the current process: it inherits the
+ * automaton and the BDD tables copy-on-write, runs the tasks i where
+ * i % total_workers equals its index, and sends the results back over a pipe.
+ */
+class ForkWorkersPool {
+   private:
+    unsigned m_total_workers;
+    std::atomic<bool>& m_stop_flag;
+
+   public:
+    // Value of a task whose worker has not reported it (stopped or crashed)
+    static constexpr int8_t UNKNOWN_RESULT = -1;
+
+    ForkWorkersPool(unsigned total_workers, std::atomic<bool>& stop_flag)
+        : m_total_workers(total_workers), m_stop_flag(stop_flag) {}
+
+    /**
+     * @brief Run task(0), ..., task(total_tasks - 1), results[i] is set to the result
+     * of task(i) or to UNKNOWN_RESULT. If the stop flag is raised, the workers are
+     * killed. Return true if all the tasks are reported.
+     */
+    bool run(size_t total_tasks, const std::function<bool(size_t)>& task,
+             std::vector<int8_t>& results);
+};
+
+#endif
@@ -0,0 +1,93 @@
+#include "forked_task.h"
+
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdlib>
+#include <stdexcept>
+
+#define FORKED_TASK_READ_BUFFER_SIZE 65536
+
+ForkedTask::ForkedTask(const std::function<std::string()>& task) {
+    int fds[2];
+    if (pipe(fds) != 0) {
+        throw std::runtime_error("Can't create a pipe for a forked task");
+    }
+
+    m_pid = fork();
+    if (m_pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        throw std::runtime_error("Can't fork a process for a task");
+    }
+
+    if (m_pid == 0) {
+        // Task process, never returns to the caller. A signal to the group must not run
+        // the parent's handlers (e.g. dumping the measures) in the task.
+        signal(SIGTERM, SIG_DFL);
+        signal(SIGINT, SIG_DFL);
+        signal(SIGHUP, SIG_DFL);
+        close(fds[0]);
+        try {
+            std::string result = task();
+            size_t total_written = 0;
+            while (total_written < result.size()) {
+                ssize_t written = write(fds[1], result.data() + total_written,
+                                        result.size() - total_written);
+                if (written < 0 && errno != EINTR) {
+                    _exit(EXIT_FAILURE);
+                }
+                total_written += written > 0 ? written : 0;
+            }
+        } catch (...) {
+            _exit(EXIT_FAILURE);
+        }
+        close(fds[1]);
+        _exit(EXIT_SUCCESS);
+    }
+
+    close(fds[1]);
+    m_result_fd = fds[0];
+}
+
+bool ForkedTask::wait(std::string& result) {
+    if (m_pid <= 0) {
+        return false;
+    }
+
+    // The result is read while it's written, a result bigger than the pipe would block it
+    result.clear();
+    char buffer[FORKED_TASK_READ_BUFFER_SIZE];
+    while (true) {
+        ssize_t total_read = read(m_result_fd, buffer, sizeof(buffer));
+        if (total_read < 0 && errno == EINTR) {
+            continue;
+        }
+        if (total_read <= 0) {
+            break;
+        }
+        result.append(buffer, total_read);
+    }
+    close(m_result_fd);
+
+    int status = 0;
+    while (waitpid(m_pid, &status, 0) < 0 && errno == EINTR) {
+    }
+    m_pid = -1;
+
+    return WIFEXITED(status) && WEXITSTATUS(status) == EXIT_SUCCESS;
+}
+
+void ForkedTask::cancel() {
+    if (m_pid <= 0) {
+        return;
+    }
+
+    kill(m_pid, SIGKILL);
+    close(m_result_fd);
+    while (waitpid(m_pid, nullptr, 0) < 0 && errno == EINTR) {
+    }
+    m_pid = -1;
+}
@@ -0,0 +1,39 @@
+#ifndef FORKED_TASK_H
+#define FORKED_TASK_H
+
+#include <sys/types.h>
+
+#include <functional>
+#include <string>
+
+/**
+ * @brief Run a task in a forked process while the current process goes on.
+ *
+ * BuDDy can't be used by two threads, so BDD work can only overlap between processes:
+ * the task's process inherits the automata and the BDD tables copy-on-write, and sends
+ * its result back as bytes over a pipe.
+ */
+class ForkedTask {
+   private:
+    pid_t m_pid;
+    int m_result_fd;
+
+   public:
+    explicit ForkedTask(const std::function<std::string()>& task);
+
+    // The task is cancelled if it wasn't waited for
+    ~ForkedTask() { cancel(); }
+
+    ForkedTask(const ForkedTask&) = delete;
+    ForkedTask& operator=(const ForkedTask&) = delete;
+
+    /**
+     * @brief Wait for the task to end, return false if it failed, crashed or was cancelled.
+     */
+    bool wait(std::string& result);
+
+    // Kill the task's process
+    void cancel();
+};
+
+#endif
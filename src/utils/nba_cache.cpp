@@ -0,0 +1,242 @@
+#include "nba_cache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+#include <spot/misc/version.hh>
+#include <spot/parseaut/public.hh>
+#include <spot/tl/print.hh>
+#include <spot/twaalgos/hoa.hh>
+
+#define NBA_CACHE_NAME_PROP "automaton-name"
+#define NBA_CACHE_VARS_COMMENT "bdd-vars:"
+
+// FNV-1a, a stable hash across builds and platforms
+static uint64_t hash_key(const std::string& key) {
+    uint64_t hash = 14695981039346656037ULL;
+    for (unsigned char c : key) {
+        hash ^= c;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+// The HOA parser infers the determinism and completeness that the translation may leave
+// unknown, and the later steps depend on them, so their values are kept with the key
+static std::string get_props_suffix(spot::trival is_universal, spot::trival is_complete) {
+    std::stringstream suffix;
+    suffix << ";universal=" << is_universal << ";complete=" << is_complete;
+    return suffix.str();
+}
+
+NBACache::NBACache(const std::string& cache_dir) : m_cache_dir(cache_dir) {
+    if (mkdir(m_cache_dir.c_str(), 0755) != 0 && errno != EEXIST) {
+        throw std::runtime_error("Can't create the NBA cache directory: " + m_cache_dir);
+    }
+}
+
+std::string NBACache::get_entry_path(const std::string& key) const {
+    std::stringstream path;
+    path << m_cache_dir << "/" << std::hex << std::setw(16) << std::setfill('0')
+         << hash_key(key) << ".hoa";
+    return path.str();
+}
+
+std::string NBACache::make_key(SyntInstance& synt_instance,
+                               const spot::option_map& options,
+                               const spot::bdd_dict_ptr& dict) {
+    std::stringstream key;
+    key << "spot=" << spot::version();
+    key << ";options=" << options;
+    key << ";inputs=";
+    for (auto& var : synt_instance.get_input_vars()) {
+        key << var << ",";
+    }
+    key << ";outputs=";
+    for (auto& var : synt_instance.get_output_vars()) {
+        key << var << ",";
+    }
+    key << ";formula=" << spot::str_psl(synt_instance.get_formula_parsed(), true);
+
+    // The propositions registered before the translation, by their variables
+    std::vector<std::pair<int, std::string>> registered_vars;
+    for (auto& ap_var : dict->var_map) {
+        registered_vars.emplace_back(ap_var.second, ap_var.first.ap_name());
+    }
+    std::sort(registered_vars.begin(), registered_vars.end());
+    key << ";vars=";
+    for (auto& registered_var : registered_vars) {
+        key << registered_var.second << ":" << registered_var.first << ",";
+    }
+
+    // The key is stored as a HOA string, so escaped characters are avoided
+    std::string key_str = key.str();
+    for (char& c : key_str) {
+        if (c == '\\' || !std::isprint(static_cast<unsigned char>(c))) {
+            c = ' ';
+        }
+    }
+    return key_str;
+}
+
+spot::twa_graph_ptr NBACache::load(const std::string& key,
+                                   const spot::bdd_dict_ptr& dict) const {
+    std::ifstream in(get_entry_path(key));
+    if (!in) {
+        return nullptr;
+    }
+    std::stringstream content;
+    content << in.rdbuf();
+    std::string hoa = content.str();
+
+    std::vector<int> ap_vars;  // The variables by the order of the translation's AP list
+    std::stringstream vars_line(hoa.substr(0, hoa.find('\n')));
+    std::string token;
+    vars_line >> token >> token;
+    if (token != NBA_CACHE_VARS_COMMENT) {
+        return nullptr;
+    }
+    while (vars_line >> token && token != "*/") {
+        ap_vars.push_back(std::stoi(token));
+    }
+
+    std::vector<int> sorted_ap_vars(ap_vars);
+    std::sort(sorted_ap_vars.begin(), sorted_ap_vars.end());
+
+    // The free variables up to the recorded ones are reserved while parsing, then each
+    // proposition is moved to its recorded variable
+    int reserving_owner;
+    int max_var = sorted_ap_vars.empty() ? -1 : sorted_ap_vars.back();
+    int var;
+    do {
+        var = dict->register_anonymous_variables(1, &reserving_owner);
+    } while (var < max_var);
+
+    spot::automaton_stream_parser parser(hoa.c_str(), get_entry_path(key));
+    spot::parsed_aut_ptr parsed = parser.parse(dict);
+    spot::twa_graph_ptr nba = parsed->aut;
+    if (parsed->aborted || !parsed->errors.empty() || nba == nullptr ||
+        nba->ap().size() != ap_vars.size() ||
+        !restore_ap_vars(nba, sorted_ap_vars, &reserving_owner)) {
+        dict->unregister_all_my_variables(&reserving_owner);
+        return nullptr;
+    }
+
+    // Restore the order of the AP list, the propositions are kept registered meanwhile
+    dict->register_all_variables_of(nba, &reserving_owner);
+    for (int ap_var : sorted_ap_vars) {
+        nba->unregister_ap(ap_var);
+    }
+    for (int ap_var : ap_vars) {
+        nba->register_ap(dict->bdd_map[ap_var].f);
+    }
+    dict->unregister_all_my_variables(&reserving_owner);
+
+    auto* name = nba->get_named_prop<std::string>(NBA_CACHE_NAME_PROP);
+    if (name == nullptr || name->compare(0, key.size(), key) != 0) {
+        return nullptr;
+    }
+    std::string props_suffix = name->substr(key.size());
+    nba->set_named_prop(NBA_CACHE_NAME_PROP, nullptr);
+
+    const spot::trival values[] = {spot::trival(true), spot::trival(false),
+                                   spot::trival::maybe()};
+    for (auto is_universal : values) {
+        for (auto is_complete : values) {
+            if (props_suffix == get_props_suffix(is_universal, is_complete)) {
+                nba->prop_universal(is_universal);
+                nba->prop_complete(is_complete);
+                return nba;
+            }
+        }
+    }
+    return nullptr;
+}
+
+bool NBACache::restore_ap_vars(const spot::twa_graph_ptr& nba, const std::vector<int>& ap_vars,
+                               const void* reserving_owner) {
+    const spot::bdd_dict_ptr& dict = nba->get_dict();
+    std::vector<spot::formula> aps = nba->ap();
+    std::vector<int> parsed_vars;
+    for (auto& ap : aps) {
+        parsed_vars.push_back(dict->varnum(ap));
+        nba->unregister_ap(parsed_vars.back());
+    }
+
+    // The variables are restored by increasing order. The released variable is then a
+    // single free variable before the parsed ones, so registering the proposition picks it
+    bddPair* pairs = bdd_newpair();
+    bool is_restored = true;
+    for (size_t i = 0; i < aps.size() && is_restored; i++) {
+        if (parsed_vars[i] != ap_vars[i]) {
+            dict->unregister_variable(ap_vars[i], reserving_owner);
+            bdd_setpair(pairs, parsed_vars[i], ap_vars[i]);
+        }
+        is_restored = nba->register_ap(aps[i]) == ap_vars[i];
+    }
+
+    if (is_restored) {
+        for (auto& edge : nba->edges()) {
+            edge.cond = bdd_replace(edge.cond, pairs);
+        }
+    }
+    bdd_freepair(pairs);
+    return is_restored;
+}
+
+bool NBACache::store(const std::string& key, const spot::twa_graph_ptr& nba) const {
+    std::string path = get_entry_path(key);
+    std::string tmp_path = path + ".tmp." + std::to_string(getpid());
+
+    // The later steps depend on the BDD variables of the propositions and on the order
+    // of the AP list, the variables are recorded by that order in a leading comment.
+    // The HOA lists the propositions by their variables, which the parser follows. The
+    // key is written as the automaton's name, with the properties.
+    spot::twa_graph_ptr entry = spot::make_twa_graph(nba, spot::twa::prop_set::all());
+    std::vector<spot::formula> aps = nba->ap();
+    const spot::bdd_dict_ptr& dict = nba->get_dict();
+    std::sort(aps.begin(), aps.end(),
+              [&dict](const spot::formula& ap1, const spot::formula& ap2) {
+                  return dict->varnum(ap1) < dict->varnum(ap2);
+              });
+    for (auto& ap : aps) {
+        entry->unregister_ap(dict->varnum(ap));
+    }
+    for (auto& ap : aps) {
+        entry->register_ap(ap);
+    }
+    entry->set_named_prop(NBA_CACHE_NAME_PROP,
+                          new std::string(key + get_props_suffix(nba->prop_universal(),
+                                                                 nba->prop_complete())));
+
+    bool is_written;
+    {
+        std::ofstream out(tmp_path);
+        out << "/* " << NBA_CACHE_VARS_COMMENT;
+        for (auto& ap : nba->ap()) {
+            out << " " << dict->varnum(ap);
+        }
+        out << " */\n";
+        spot::print_hoa(out, entry);
+        out << '\n';
+        is_written = out.good();
+    }
+
+    // Concurrent runs may store the same entry, renaming makes it atomic
+    if (!is_written || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
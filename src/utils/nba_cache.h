@@ -0,0 +1,48 @@
+#ifndef NBA_CACHE_H
+#define NBA_CACHE_H
+
+#include <spot/misc/optionmap.hh>
+#include <spot/twa/twagraph.hh>
+#include <string>
+#include <vector>
+
+#include "synt_instance.h"
+
+/**
+ * @brief Directory of translated (and pruned) NBAs in HOA format, so repeated runs on
+ * the same specification skip the translation.
+ *
+ * An entry is named by a hash of its key: the formula, the input/output partition,
+ * the translator options, the propositions already registered in the BDD dictionary
+ * (e.g. the interleaved prime variables, which change the variables of the translation)
+ * and spot's version. The key itself is stored as the
+ * automaton's name and compared on load, so a hash collision is just a miss. The BDD
+ * variables of the propositions are recorded too and restored on load, since the
+ * strategy built from the NBA depends on them.
+ */
+class NBACache {
+   private:
+    std::string m_cache_dir;
+
+    std::string get_entry_path(const std::string& key) const;
+
+    // Move the propositions (listed by their variables) to the sorted variables of the
+    // translation, which are reserved by reserving_owner. Return false if a variable
+    // couldn't be restored
+    static bool restore_ap_vars(const spot::twa_graph_ptr& nba, const std::vector<int>& ap_vars,
+                                const void* reserving_owner);
+
+   public:
+    explicit NBACache(const std::string& cache_dir);
+
+    static std::string make_key(SyntInstance& synt_instance, const spot::option_map& options,
+                                const spot::bdd_dict_ptr& dict);
+
+    // Return nullptr if the NBA is not cached
+    spot::twa_graph_ptr load(const std::string& key, const spot::bdd_dict_ptr& dict) const;
+
+    // Return false if the NBA couldn't be written
+    bool store(const std::string& key, const spot::twa_graph_ptr& nba) const;
+};
+
+#endif
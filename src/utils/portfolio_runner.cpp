@@ -0,0 +1,177 @@
+#include "portfolio_runner.h"
+
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <iostream>
+#include <stdexcept>
+
+#define PORTFOLIO_MAX_CONFIGS 16
+#define PORTFOLIO_READ_BUFFER_SIZE 65536
+
+using json = nlohmann::json;
+
+// The process groups of the running configurations, for the signal handler
+static volatile pid_t g_portfolio_groups[PORTFOLIO_MAX_CONFIGS];
+
+static void on_portfolio_signal(int signum) {
+    for (int i = 0; i < PORTFOLIO_MAX_CONFIGS; i++) {
+        if (g_portfolio_groups[i] > 0) {
+            kill(-g_portfolio_groups[i], SIGKILL);
+        }
+    }
+    signal(signum, SIG_DFL);
+    raise(signum);
+}
+
+// Split the output of a configuration into its text and its measures (the last JSON line)
+static bool split_measures(const std::string& output, std::string& text, json& measures) {
+    size_t end = output.find_last_not_of("\n");
+    if (end == std::string::npos) {
+        return false;
+    }
+    size_t begin = output.rfind('\n', end);
+    begin = begin == std::string::npos ? 0 : begin + 1;
+    if (output[begin] != '{') {
+        return false;
+    }
+
+    try {
+        measures = json::parse(output.substr(begin, end - begin + 1));
+    } catch (const json::exception&) {
+        return false;
+    }
+    text = output.substr(0, begin);
+    return true;
+}
+
+PortfolioResult PortfolioRunner::run(const std::vector<PortfolioConfig>& configs) const {
+    if (configs.size() > PORTFOLIO_MAX_CONFIGS) {
+        throw std::runtime_error("Too many configurations for the portfolio");
+    }
+
+    PortfolioResult result;
+    result.status.assign(configs.size(), "killed");
+    TimeMeasure portfolio_time;
+    portfolio_time.start();
+
+    auto prev_sigterm = signal(SIGTERM, on_portfolio_signal);
+    auto prev_sigint = signal(SIGINT, on_portfolio_signal);
+    auto prev_sighup = signal(SIGHUP, on_portfolio_signal);
+
+    // Otherwise the buffered output is written by all the processes
+    std::cout.flush();
+    std::cerr.flush();
+
+    std::vector<pid_t> pids(configs.size(), -1);
+    std::vector<pollfd> pipes(configs.size(), pollfd{-1, POLLIN, 0});
+    std::vector<std::string> outputs(configs.size());
+    for (size_t i = 0; i < configs.size(); i++) {
+        int fds[2];
+        if (pipe(fds) != 0) {
+            throw std::runtime_error("Can't create a pipe for the portfolio");
+        }
+
+        pid_t pid = fork();
+        if (pid < 0) {
+            close(fds[0]);
+            close(fds[1]);
+            throw std::runtime_error("Can't fork a process for the portfolio");
+        }
+
+        if (pid == 0) {
+            // Configuration process, its own group so its workers are killed with it
+            setpgid(0, 0);
+            signal(SIGTERM, prev_sigterm);
+            signal(SIGINT, prev_sigint);
+            signal(SIGHUP, prev_sighup);
+            for (size_t j = 0; j < i; j++) {
+                close(pipes[j].fd);
+            }
+            close(fds[0]);
+            dup2(fds[1], STDOUT_FILENO);
+            close(fds[1]);
+
+            int exit_code = configs[i].synthesize();
+            std::cout.flush();
+            std::cerr.flush();
+            _exit(exit_code);
+        }
+
+        close(fds[1]);
+        setpgid(pid, pid);
+        pids[i] = pid;
+        pipes[i].fd = fds[0];
+        g_portfolio_groups[i] = pid;
+    }
+
+    size_t total_running = configs.size();
+    char buffer[PORTFOLIO_READ_BUFFER_SIZE];
+    while (total_running > 0 && result.winner < 0) {
+        int ready = poll(pipes.data(), pipes.size(), -1);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready < 0) {
+            break;
+        }
+
+        for (size_t i = 0; i < configs.size() && result.winner < 0; i++) {
+            if (pipes[i].fd < 0 || pipes[i].revents == 0) {
+                continue;
+            }
+
+            ssize_t total_read = read(pipes[i].fd, buffer, sizeof(buffer));
+            if (total_read < 0 && errno == EINTR) {
+                continue;
+            }
+            if (total_read > 0) {
+                outputs[i].append(buffer, total_read);
+                continue;
+            }
+
+            // The configuration exited, it wins if it reached a verdict
+            close(pipes[i].fd);
+            pipes[i].fd = -1;
+            while (waitpid(pids[i], nullptr, 0) < 0 && errno == EINTR) {
+            }
+            g_portfolio_groups[i] = 0;
+            pids[i] = -1;
+            total_running--;
+
+            json measures;
+            std::string text;
+            if (split_measures(outputs[i], text, measures) &&
+                measures.value("is_completed", false)) {
+                result.winner = static_cast<int>(i);
+                result.output = text;
+                result.measures = measures;
+                result.status[i] = "won";
+            } else {
+                result.status[i] = "failed";
+            }
+        }
+    }
+
+    // Kill the configurations that lost the race
+    for (size_t i = 0; i < configs.size(); i++) {
+        if (pids[i] <= 0) {
+            continue;
+        }
+        kill(-pids[i], SIGKILL);
+        close(pipes[i].fd);
+        while (waitpid(pids[i], nullptr, 0) < 0 && errno == EINTR) {
+        }
+        g_portfolio_groups[i] = 0;
+    }
+
+    signal(SIGTERM, prev_sigterm);
+    signal(SIGINT, prev_sigint);
+    signal(SIGHUP, prev_sighup);
+
+    result.duration = portfolio_time.time_elapsed();
+    return result;
+}
@@ -0,0 +1,42 @@
+#ifndef PORTFOLIO_RUNNER_H
+#define PORTFOLIO_RUNNER_H
+
+#include <sys/types.h>
+
+#include <functional>
+#include <nlohmann/json.hpp>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+// A way to synthesize the specification, its return value is the exit code of its process
+struct PortfolioConfig {
+    std::string name;
+    std::function<int()> synthesize;
+};
+
+struct PortfolioResult {
+    int winner = -1;                 // Index of the winning configuration, -1 if none won
+    std::string output;              // The winner's output, without its measures
+    nlohmann::json measures;         // The winner's measures, null if none won
+    std::vector<std::string> status; // Per configuration: won, killed or failed
+    Duration duration = 0;
+};
+
+/**
+ * @brief Race configurations of the synthesis of a specification, each in a forked
+ * process whose standard output is sent back over a pipe, with its measures JSON as its
+ * last line (i.e., the configurations must not write their measures to a file).
+ *
+ * The first configuration whose measures are completed (a realizable or unrealizable
+ * verdict) wins and the others are killed. Each configuration is its own process group,
+ * so its workers are killed with it, also when the runner itself gets SIGTERM, SIGINT or
+ * SIGHUP.
+ */
+class PortfolioRunner {
+   public:
+    PortfolioResult run(const std::vector<PortfolioConfig>& configs) const;
+};
+
+#endif
@@ -4,12 +4,14 @@
 #include <algorithm>
 #include <iostream>
 #include <string>
+#include <unordered_set>
 #include <vector>
 
 #include "utils.h"
 
 void SyntInstance::build_all_vars() {
     for (std::string& var : boost::join(m_input_vars, m_output_vars)) {
+        m_var_ids.emplace(var, static_cast<VarId>(m_all_vars.size()));
         m_all_vars.push_back(var);
     }
 }
@@ -47,13 +49,43 @@ void SyntInstance::all_vars_excluded(std::vector<std::string>& dst,
                                      const std::vector<std::string>& excluded) {
     dst.clear();
 
+    std::unordered_set<std::string> excluded_set(excluded.begin(), excluded.end());
     for (const std::string& var : m_all_vars) {
-        if (std::find(excluded.begin(), excluded.end(), var) == excluded.end()) {
+        if (excluded_set.find(var) == excluded_set.end()) {
             dst.push_back(var);
         }
     }
 }
 
+VarId SyntInstance::get_var_id(const std::string& var) const {
+    auto id_it = m_var_ids.find(var);
+    if (id_it == m_var_ids.end()) {
+        throw std::runtime_error("Unknown variable: " + var);
+    }
+    return id_it->second;
+}
+
+std::vector<VarId> SyntInstance::get_input_ids() const {
+    std::vector<VarId> ids;
+    for (const std::string& var : m_input_vars) {
+        ids.push_back(get_var_id(var));
+    }
+    return ids;
+}
+
+std::vector<VarId> SyntInstance::get_output_ids() const {
+    std::vector<VarId> ids;
+    for (const std::string& var : m_output_vars) {
+        ids.push_back(get_var_id(var));
+    }
+    return ids;
+}
+
+void SyntInstance::get_var_names(const VarSet& vars, std::vector<std::string>& dst) const {
+    dst.clear();
+    vars.for_each([&](VarId id) { dst.push_back(m_all_vars[id]); });
+}
+
 void SyntInstance::order_output_vars(std::vector<std::string>& expected_order) {
     auto pred = [&expected_order](const std::string& a, const std::string& b) {
         auto it_a = std::find(expected_order.begin(), expected_order.end(), a);
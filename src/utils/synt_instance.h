@@ -11,11 +11,15 @@
 #include <spot/twaalgos/postproc.hh>
 #include <spot/twaalgos/translate.hh>
 #include <string>
+#include <unordered_map>
 #include <vector>
 
+#include "var_set.h"
+
 class SyntInstance {
    private:
-    std::vector<std::string> m_all_vars;
+    std::vector<std::string> m_all_vars;  // Indexed by VarId
+    std::unordered_map<std::string, VarId> m_var_ids;
     std::vector<std::string> m_input_vars;
     std::vector<std::string> m_output_vars;
     std::string m_formula;
@@ -45,6 +49,21 @@ class SyntInstance {
     void all_vars_excluded(std::vector<std::string>& dst,
                            const std::vector<std::string>& excluded);
 
+    size_t get_total_vars() const { return m_all_vars.size(); }
+
+    VarId get_var_id(const std::string& var) const;
+
+    bool has_var(const std::string& var) const { return m_var_ids.count(var) > 0; }
+
+    const std::string& get_var_name(VarId id) const { return m_all_vars[id]; }
+
+    // Ids of the variables, in the same order as in get_input_vars/get_output_vars
+    std::vector<VarId> get_input_ids() const;
+
+    std::vector<VarId> get_output_ids() const;
+
+    void get_var_names(const VarSet& vars, std::vector<std::string>& dst) const;
+
     // Make sure that the order in output variables is the same as in expected_order
     void order_output_vars(std::vector<std::string>& expected_order);
 
@@ -57,6 +76,9 @@ class SyntInstance {
     friend spot::twa_graph_ptr construct_automaton(SyntInstance& synt_instance);
 };
 
+// We make a prime variable by adding the suffix "_pp" to variable's name
+inline std::string get_prime_variable(const std::string& var) { return var + "_pp"; }
+
 spot::twa_graph_ptr construct_automaton(SyntInstance& synt_instance);
 
 spot::twa_graph_ptr construct_automaton_negation(SyntInstance& synt_instance, const spot::bdd_dict_ptr& dict);
@@ -8,6 +8,9 @@ void aiger_description_obj(json& obj, const AigerDescription& description) {
     obj.emplace("total_outputs", description.outputs);
     obj.emplace("total_latches", description.latches);
     obj.emplace("total_gates", description.gates);
+    if (!description.state_encoding.empty()) {
+        obj.emplace("state_encoding", description.state_encoding);
+    }
 }
 
 void nba_bdd_summary_obj(json& obj, const NBABDDSummary& sum) {
@@ -90,6 +93,10 @@ void BaseMeasures::get_json_object(json& obj) const {
     automaton["prune_total_states"] =
             static_cast<int>(this->m_total_prune_automaton_states);
     automaton["total_edges"] = this->m_total_automaton_edges;
+    if (this->m_nba_cache_hits + this->m_nba_cache_misses > 0) {
+        automaton["nba_cache_hits"] = this->m_nba_cache_hits;
+        automaton["nba_cache_misses"] = this->m_nba_cache_misses;
+    }
 
     obj.emplace("automaton", automaton);
 
@@ -176,6 +183,29 @@ void AutomatonFindDepsMeasure::get_json_object(json& obj) const {
     dependency_obj["is_completed"] = m_is_search_dependencies_completed;
     dependency_obj["skipped_dependencies"] = this->m_skipped_dependency_check;
     dependency_obj["total_pair_state"] = this->m_total_pair_states;
+    dependency_obj["pair_states_engine"] = this->m_pair_states_engine;
+    dependency_obj["pair_states_workers"] = this->m_pair_states_workers;
+    dependency_obj["dependency_check_backend"] = this->m_dependency_check_backend;
+    dependency_obj["dependency_workers"] = this->m_dependency_workers;
+    dependency_obj["speculative_rechecks"] = this->m_speculative_rechecks;
+    dependency_obj["prime_vars_layout"] = this->m_prime_vars_layout;
+    if (this->m_dependency_check_bdd_nodes >= 0) {
+        dependency_obj["dependency_check_bdd_nodes"] = this->m_dependency_check_bdd_nodes;
+    }
+    if (this->m_sat_calls >= 0) {
+        dependency_obj["sat_calls"] = this->m_sat_calls;
+    }
+    if (this->m_symbolic_pair_states_bdd_size >= 0) {
+        dependency_obj["symbolic_pair_states_bdd_size"] =
+            this->m_symbolic_pair_states_bdd_size;
+    }
+    dependency_obj["visited_pairs_structure"] = this->m_visited_pairs_structure;
+    dependency_obj["visited_pairs_memory_bytes"] = this->m_visited_pairs_memory;
+    dependency_obj["restrictions_cache_hits"] = this->m_restrictions_cache_hits;
+    dependency_obj["restrictions_cache_misses"] = this->m_restrictions_cache_misses;
+    dependency_obj["conflict_pair_states"] = this->m_conflict_pair_states;
+    dependency_obj["refuted_by_conflict_pair_states"] =
+        this->m_refuted_by_conflict_pair_states;
     if (this->m_search_pair_states_time.has_started()) {
         dependency_obj["search_pair_state_duration"] =
             this->m_search_pair_states_time.get_duration();
@@ -195,6 +225,8 @@ void SynthesisMeasure::end_independents_synthesis(spot::aig_ptr& aiger_strat) {
 
 void SynthesisMeasure::get_json_object(json& obj) const {
     AutomatonFindDepsMeasure::get_json_object(obj);
+    obj.emplace("model_name", m_model_name);
+    obj.emplace("synthesis_algo", m_synthesis_algo);
 
     // Unate
     json unate_obj;
@@ -212,13 +244,15 @@ void SynthesisMeasure::get_json_object(json& obj) const {
         synthesis_process_obj.emplace("remove_dependent_ap_duration",
                                       m_remove_dependent_ap.get_duration());
     }
-    if (m_clone_nba_with_deps.has_started()) {
-        synthesis_process_obj.emplace("clone_nba_with_dep",
-                                      m_clone_nba_with_deps.get_duration());
+    Duration dependents_duration = m_forked_dependents_duration >= 0
+                                       ? m_forked_dependents_duration
+                                       : m_dependents_total_duration.get_duration();
+    if (m_dependents_total_duration.has_started() || m_forked_dependents_duration >= 0) {
+        synthesis_process_obj.emplace("synthesis_dependents_duration", dependents_duration);
     }
-    if (m_dependents_total_duration.has_started()) {
-        synthesis_process_obj.emplace("synthesis_dependents_duration",
-                                      m_dependents_total_duration.get_duration());
+    if (m_dependents_wait.has_started()) {
+        synthesis_process_obj.emplace("synthesis_dependents_wait_duration",
+                                      m_dependents_wait.get_duration());
     }
     synthesis_process_obj.emplace("model_checking_status", m_model_checking_status);
     if (m_model_checking.has_started()) {
@@ -237,16 +271,38 @@ void SynthesisMeasure::get_json_object(json& obj) const {
     independent_strategy_obj.emplace("realizability", m_independents_realizable);
     aiger_description_obj(independent_strategy_obj, m_independent_strategy);
 
-    dependent_strategy_obj.emplace("duration",
-                                   m_dependents_total_duration.get_duration());
+    dependent_strategy_obj.emplace("duration", dependents_duration);
     aiger_description_obj(dependent_strategy_obj, m_dependent_strategy);
+    if (!m_dependent_strategy_encodings.empty()) {
+        json encodings_obj = json::array();
+        for (auto& encoding : m_dependent_strategy_encodings) {
+            json encoding_obj;
+            aiger_description_obj(encoding_obj, encoding);
+            encodings_obj.push_back(encoding_obj);
+        }
+        dependent_strategy_obj.emplace("encodings", encodings_obj);
+    }
 
     if(m_merge_strategies.has_started()) {
         json final_strategy_obj;
         final_strategy_obj.emplace("merge_duration",
                                        m_merge_strategies.get_duration());
         aiger_description_obj(final_strategy_obj, m_final_strategy);
-        synthesis_process_obj.emplace("final_strategy", dependent_strategy_obj);
+        if (m_abc_optimization.has_started()) {
+            json abc_obj, passes_obj = json::array();
+            for (auto& pass : m_abc_passes) {
+                json pass_obj;
+                pass_obj.emplace("command", pass.command);
+                pass_obj.emplace("gates", pass.gates);
+                pass_obj.emplace("duration", pass.duration);
+                passes_obj.push_back(pass_obj);
+            }
+            abc_obj.emplace("script", m_abc_script);
+            abc_obj.emplace("duration", m_abc_optimization.get_duration());
+            abc_obj.emplace("passes", passes_obj);
+            final_strategy_obj.emplace("abc_optimization", abc_obj);
+        }
+        synthesis_process_obj.emplace("final_strategy", final_strategy_obj);
     }
 
     synthesis_process_obj.emplace("independent_strategy", independent_strategy_obj);
@@ -279,7 +335,8 @@ void dump_measures(const BaseDependentsMeasures& sm, BaseCLIOptions& cli_options
         return;
     }
 
-    ofstream measure_file(cli_options.measures_path);
+    ofstream measure_file(cli_options.measures_path,
+                          cli_options.append_measures ? ios::app : ios::trunc);
 
     if (measure_file.is_open()) {
         measure_file << sm << endl;
@@ -11,6 +11,7 @@
 #include "bdd_utils.h"
 #include "utils.h"
 #include "unate_utils.h"
+#include "abc_utils.h"
 
 using namespace std;
 
@@ -28,6 +29,7 @@ struct AigerDescription {
     int outputs = -1;
     int latches = -1;
     int gates = -1;
+    string state_encoding;  // Of the NBA states by the latches, if the strategy has one
 };
 
 class BaseDependentsMeasures;
@@ -50,6 +52,8 @@ private:
     string m_prune_automaton_state_based_status;
     uint m_total_prune_automaton_states;
     int m_total_automaton_edges;
+    int m_nba_cache_hits;
+    int m_nba_cache_misses;
 
     // BDD Measure
     NBABDDSummary m_origin_nba_bdd_summary;
@@ -70,6 +74,8 @@ public:
               m_total_automaton_states(-1),
               m_total_prune_automaton_states(-1),
               m_total_automaton_edges(-1),
+              m_nba_cache_hits(0),
+              m_nba_cache_misses(0),
               m_is_completed(false),
               m_measure_bdd(false) {
         m_total_time.start();
@@ -85,6 +91,10 @@ public:
 
     void end_prune_automaton(spot::twa_graph_ptr &pruned_automaton);
 
+    void add_nba_cache_hit() { m_nba_cache_hits++; }
+
+    void add_nba_cache_miss() { m_nba_cache_misses++; }
+
     void completed() { m_is_completed = true; }
 
     friend ostream &operator<<(ostream &os, const BaseMeasures &sm);
@@ -126,6 +136,21 @@ class AutomatonFindDepsMeasure : public BaseDependentsMeasures {
 private:
     TimeMeasure m_search_pair_states_time;
     int m_total_pair_states;
+    unsigned m_pair_states_workers;
+    string m_pair_states_engine;
+    int m_symbolic_pair_states_bdd_size;
+    string m_visited_pairs_structure;
+    size_t m_visited_pairs_memory;
+    long m_restrictions_cache_hits;
+    long m_restrictions_cache_misses;
+    size_t m_conflict_pair_states;
+    long m_refuted_by_conflict_pair_states;
+    string m_dependency_check_backend;
+    long m_sat_calls;
+    unsigned m_dependency_workers;
+    long m_speculative_rechecks;
+    string m_prime_vars_layout;
+    long m_dependency_check_bdd_nodes;
     bool m_skipped_dependency_check;
     bool m_is_search_dependencies_completed;
     TimeMeasure m_total_find_deps_duration;
@@ -138,6 +163,21 @@ public:
                                       bool skipped_dependency_check)
             : BaseDependentsMeasures(m_synt_instance),
               m_total_pair_states(-1),
+              m_pair_states_workers(1),
+              m_pair_states_engine("UNKNOWN"),
+              m_symbolic_pair_states_bdd_size(-1),
+              m_visited_pairs_structure("UNKNOWN"),
+              m_visited_pairs_memory(0),
+              m_restrictions_cache_hits(0),
+              m_restrictions_cache_misses(0),
+              m_conflict_pair_states(0),
+              m_refuted_by_conflict_pair_states(0),
+              m_dependency_check_backend("bdd"),
+              m_sat_calls(-1),
+              m_dependency_workers(1),
+              m_speculative_rechecks(0),
+              m_prime_vars_layout("UNKNOWN"),
+              m_dependency_check_bdd_nodes(-1),
               m_skipped_dependency_check(skipped_dependency_check) {}
 
     void start_find_deps() { m_total_find_deps_duration.start(); }
@@ -147,6 +187,51 @@ public:
     void start_search_pair_states();
 
     void end_search_pair_states(int total_pair_states);
+
+    void set_pair_states_workers(unsigned total_workers) {
+        m_pair_states_workers = total_workers;
+    }
+
+    void set_pair_states_engine(const char* engine) { m_pair_states_engine = engine; }
+
+    void set_symbolic_pair_states_bdd_size(int bdd_size) {
+        m_symbolic_pair_states_bdd_size = bdd_size;
+    }
+
+    void add_restrictions_cache_stats(long hits, long misses) {
+        m_restrictions_cache_hits += hits;
+        m_restrictions_cache_misses += misses;
+    }
+
+    void set_conflict_pair_states(size_t total_pair_states) {
+        m_conflict_pair_states = total_pair_states;
+    }
+
+    void add_refuted_by_conflict_pair_state() { m_refuted_by_conflict_pair_states++; }
+
+    void set_dependency_check_backend(const char* backend) {
+        m_dependency_check_backend = backend;
+    }
+
+    void set_sat_calls(long total_calls) { m_sat_calls = total_calls; }
+
+    void set_dependency_workers(unsigned total_workers) {
+        m_dependency_workers = total_workers;
+    }
+
+    void add_speculative_recheck() { m_speculative_rechecks++; }
+
+    void set_prime_vars_layout(const char* layout) { m_prime_vars_layout = layout; }
+
+    // BDD nodes produced while checking the candidates (by this process only)
+    void set_dependency_check_bdd_nodes(long total_nodes) {
+        m_dependency_check_bdd_nodes = total_nodes;
+    }
+
+    void set_visited_pairs(const char* structure, size_t memory_bytes) {
+        m_visited_pairs_structure = structure;
+        m_visited_pairs_memory = memory_bytes;
+    }
 };
 
 class SynthesisMeasure : public AutomatonFindDepsMeasure, public UnatesHandlerMeasures {
@@ -154,21 +239,37 @@ private:
     TimeMeasure m_remove_dependent_ap;
     TimeMeasure m_independents_total_duration;
     TimeMeasure m_dependents_total_duration;
-    TimeMeasure m_clone_nba_with_deps;
+    TimeMeasure m_dependents_wait;        // Waiting for the forked dependents synthesis
+    Duration m_forked_dependents_duration;  // Measured in the forked process, -1 if not forked
     TimeMeasure m_model_checking;
     TimeMeasure m_merge_strategies;
+    TimeMeasure m_abc_optimization;
 
     AigerDescription m_independent_strategy;
     AigerDescription m_dependent_strategy;
     AigerDescription m_final_strategy;
+    vector<AigerDescription> m_dependent_strategy_encodings;
     NBABDDSummary m_projected_nba_bdd_summary;
+    string m_abc_script;
+    vector<AbcPass> m_abc_passes;
 
     string m_independents_realizable;
     string m_model_checking_status;
+    string m_model_name;
+    string m_synthesis_algo;
 
     // Options
     bool m_skipped_unate;
 
+    void set_dependent_strategy(spot::aig_ptr &aiger_strat, const string &state_encoding,
+                                const vector<AigerDescription> &encodings) {
+        if (aiger_strat != nullptr) {
+            extract_aiger_description(m_dependent_strategy, aiger_strat);
+            m_dependent_strategy.state_encoding = state_encoding;
+        }
+        m_dependent_strategy_encodings = encodings;
+    }
+
 protected:
     void get_json_object(json &obj) const override;
 
@@ -179,9 +280,14 @@ public:
             : AutomatonFindDepsMeasure(m_synt_instance, skipped_dependency_check),
               UnatesHandlerMeasures(),
               m_skipped_unate(skipped_unate),
+              m_forked_dependents_duration(-1),
               m_independents_realizable("UNKNOWN"),
               m_model_checking_status("UNKNOWN") {}
 
+    void set_model_name(const string &model_name) { m_model_name = model_name; }
+
+    void set_synthesis_algo(const string &algo) { m_synthesis_algo = algo; }
+
     void start_remove_dependent_ap() { m_remove_dependent_ap.start(); }
 
     void end_remove_dependent_ap(spot::twa_graph_ptr& projected_automaton) {
@@ -191,10 +297,6 @@ public:
         }
     }
 
-    void start_clone_nba_with_deps() { m_clone_nba_with_deps.start(); }
-
-    void end_clone_nba_with_deps() { m_clone_nba_with_deps.end(); }
-
     void start_model_checking() { m_model_checking.start(); }
 
     void end_model_checking(const char *status) {
@@ -208,19 +310,45 @@ public:
 
     void start_dependents_synthesis() { m_dependents_total_duration.start(); }
 
-    void end_dependents_synthesis(spot::aig_ptr &aiger_strat) {
-        if (aiger_strat != nullptr) {
-            extract_aiger_description(m_dependent_strategy, aiger_strat);
-        }
+    // encodings are the strategies of each state encoding that was built
+    void end_dependents_synthesis(spot::aig_ptr &aiger_strat, const string &state_encoding,
+                                  const vector<AigerDescription> &encodings) {
+        set_dependent_strategy(aiger_strat, state_encoding, encodings);
         m_dependents_total_duration.end();
     }
 
+    void start_waiting_dependents_synthesis() { m_dependents_wait.start(); }
+
+    void end_waiting_dependents_synthesis() { m_dependents_wait.end(); }
+
+    // The dependents were synthesized in a forked process, duration is measured there so
+    // it doesn't include the independents synthesis that ran meanwhile
+    void end_forked_dependents_synthesis(spot::aig_ptr &aiger_strat,
+                                         const string &state_encoding,
+                                         const vector<AigerDescription> &encodings,
+                                         Duration duration) {
+        set_dependent_strategy(aiger_strat, state_encoding, encodings);
+        m_forked_dependents_duration = duration;
+    }
+
     void start_merge_strategies() { m_merge_strategies.start(); }
 
     void end_merge_strategies(spot::aig_ptr &aiger_strat) {
         m_merge_strategies.end();
         extract_aiger_description(m_final_strategy, aiger_strat);
     }
+
+    void start_abc_optimization(const string &script) {
+        m_abc_script = script;
+        m_abc_optimization.start();
+    }
+
+    // The final strategy is the optimized one
+    void end_abc_optimization(spot::aig_ptr &aiger_strat, const vector<AbcPass> &passes) {
+        m_abc_optimization.end();
+        m_abc_passes = passes;
+        extract_aiger_description(m_final_strategy, aiger_strat);
+    }
 };
 
 #endif  // REACTIVE_SYNTHESIS_BFSS_SYNT_MEASURE_H
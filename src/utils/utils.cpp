@@ -1,7 +1,9 @@
 #include "utils.h"
+#include "abc_utils.h"
 
 #include <boost/program_options.hpp>
 #include <cstdio>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <stdexcept>
@@ -10,10 +12,13 @@
 namespace Options = boost::program_options;
 using namespace std;
 
-void parse_cli_common(BaseCLIOptions &options, Options::options_description &desc) {
-    desc.add_options()("formula",
-                       Options::value<string>(&options.formula)->required(),
-                       "LTL formula")(
+void parse_cli_common(BaseCLIOptions &options, Options::options_description &desc,
+                      bool is_formula_required = true) {
+    auto formula_value = Options::value<string>(&options.formula);
+    if (is_formula_required) {
+        formula_value->required();
+    }
+    desc.add_options()("formula", formula_value, "LTL formula")(
         "output", Options::value<string>(&options.outputs)->default_value(""),
 
         "Output variables")("input",
@@ -34,12 +39,15 @@ bool parse_synthesis_cli(int argc, const char *argv[],
                          SynthesisCLIOptions &options) {
     Options::options_description desc(
         "Tool to synthesis LTL specification using dependencies");
-    parse_cli_common(options, desc);
+
+    // In a batch, the specifications are read from the batch file, so the formula and
+    // the model name are only required without --batch (checked after parsing)
+    parse_cli_common(options, desc, false);
     options.skip_unates = true; // Currently, we always skip unates
     desc.add_options()
         ("help,h", "produce help message")(
             "model-name",
-            Options::value<string>(&options.model_name)->required(),
+            Options::value<string>(&options.model_name),
             "Unique model name of the specification"
         )
         ("dependency-timeout",
@@ -59,6 +67,71 @@ bool parse_synthesis_cli(int argc, const char *argv[],
         "measure-bdd",
         Options::bool_switch(&options.measure_bdd)->default_value(false),
         "Should measure the BDD size of NBAs"
+        )(
+        "pair-states-workers",
+        Options::value<unsigned>(&options.pair_states_workers)->default_value(1),
+        "Number of threads used to search the pair-states of the NBA"
+        )(
+        "pair-states-engine",
+        Options::value<string>()->default_value("auto"),
+        "How to compute the pair-states of the NBA: explicit, symbolic, auto"
+        )(
+        "sat-dependencies",
+        Options::bool_switch(&options.sat_dependencies)->default_value(false),
+        "Should check the dependencies by a SAT solver instead of BDDs"
+        )(
+        "dependency-workers",
+        Options::value<unsigned>(&options.dependency_workers)->default_value(1),
+        "Number of processes used to check the dependent variables"
+        )(
+        "interleave-prime-vars",
+        Options::bool_switch(&options.interleave_prime_vars)->default_value(false),
+        "Should allocate each prime variable next to its variable in the BDD order"
+        )(
+        "nba-cache-dir",
+        Options::value<string>(&options.nba_cache_dir)->default_value(""),
+        "Directory to cache the translated NBAs in, disabled if empty"
+        )(
+        "synthesis-algo",
+        Options::value<string>()->default_value("sd"),
+        "How to build the parity game of the NBA: sd (split, then determinize), ds, lar, acd"
+        )(
+        "portfolio",
+        Options::bool_switch(&options.portfolio)->default_value(false),
+        "Should race forked processes with and without dependencies and with each "
+        "synthesis algorithm, the first verdict wins"
+        )(
+        "state-encoding",
+        Options::value<string>()->default_value("onehot"),
+        "How the dependent strategy encodes the NBA states by latches: onehot, binary, "
+        "gray, smallest (the one with the fewest gates)"
+        )(
+        "fork-dependents-synthesis",
+        Options::bool_switch(&options.fork_dependents_synthesis)->default_value(false),
+        "Should synthesize the dependent strategy in a forked process, while the "
+        "independent strategy is synthesized"
+        )(
+        "abc-script",
+        Options::value<string>(&options.abc_script)->default_value(ABC_DEFAULT_SCRIPT),
+        "ABC commands separated by ';' to optimize the merged strategy, \"adaptive\" "
+        "to repeat optimization rounds while they shrink it, or \"none\" to skip ABC"
+        )(
+        "abc-time-budget",
+        Options::value<int>(&options.abc_time_budget)->default_value(0),
+        "Time budget of the adaptive ABC script in milliseconds, unlimited if 0"
+        )(
+        "batch",
+        Options::value<string>(&options.batch_path)->default_value(""),
+        "Synthesis the specifications of a file (benchmarks-ltl text format or JSONL) "
+        "instead of --formula, each in a forked process"
+        )(
+        "spec-timeout",
+        Options::value<int>(&options.spec_timeout)->default_value(0),
+        "Time budget of a batch specification in milliseconds, unlimited if 0"
+        )(
+        "spec-memory-limit",
+        Options::value<unsigned>(&options.spec_memory_limit)->default_value(0),
+        "Memory budget of a batch specification in MB, unlimited if 0"
         );
 
     // Check if help is requested
@@ -80,6 +153,36 @@ bool parse_synthesis_cli(int argc, const char *argv[],
         Options::store(parsed_options, vm);
         Options::notify(vm);
 
+        if (options.batch_path.empty()) {
+            for (const char *option : {"formula", "model-name"}) {
+                if (!vm.count(option)) {
+                    cerr << "the option '--" << option << "' is required but missing"
+                         << endl;
+                    cout << desc << endl;
+                    return false;
+                }
+            }
+        }
+
+        if (!string_to_pair_states_engine(vm["pair-states-engine"].as<string>(),
+                                          options.pair_states_engine)) {
+            cerr << "Unknown pair-states engine: "
+                 << vm["pair-states-engine"].as<string>() << endl;
+            return false;
+        }
+        if (!string_to_state_encoding(vm["state-encoding"].as<string>(),
+                                      options.state_encoding)) {
+            cerr << "Unknown state encoding: " << vm["state-encoding"].as<string>()
+                 << endl;
+            return false;
+        }
+        if (!string_to_synthesis_algo(vm["synthesis-algo"].as<string>(),
+                                      options.synthesis_algo)) {
+            cerr << "Unknown synthesis algorithm: " << vm["synthesis-algo"].as<string>()
+                 << endl;
+            return false;
+        }
+
         if(!options.skip_unates) {
             cerr << "Currently, unates are not supported. Please use --skip-unates option" << endl;
             return false;
@@ -128,11 +231,25 @@ bool parse_find_dependencies_cli(int argc, const char *argv[],
         "Tool to find dependencies in LTL specification");
     parse_cli_common(options, desc);
     desc.add_options()("algo", Options::value<string>(),
-                       "Which algorithm to use: formula, automaton")(
+                       "Which algorithm to use: formula, automaton, sat")(
         "find-input-only",
         Options::bool_switch(&options.find_input_dependencies)->default_value(false),
         "Search for input dependent variables instead of output dependent "
-        "variables");
+        "variables")(
+        "pair-states-workers",
+        Options::value<unsigned>(&options.pair_states_workers)->default_value(1),
+        "Number of threads used to search the pair-states of the NBA")(
+        "pair-states-engine", Options::value<string>()->default_value("auto"),
+        "How to compute the pair-states of the NBA: explicit, symbolic, auto")(
+        "dependency-workers",
+        Options::value<unsigned>(&options.dependency_workers)->default_value(1),
+        "Number of processes used to check the dependent variables")(
+        "interleave-prime-vars",
+        Options::bool_switch(&options.interleave_prime_vars)->default_value(false),
+        "Should allocate each prime variable next to its variable in the BDD order")(
+        "nba-cache-dir",
+        Options::value<string>(&options.nba_cache_dir)->default_value(""),
+        "Directory to cache the translated NBAs in, disabled if empty");
 
     try {
         Options::command_line_parser parser{argc, argv};
@@ -150,11 +267,17 @@ bool parse_find_dependencies_cli(int argc, const char *argv[],
         } else {
             options.algorithm = Algorithm::UNKNOWN;
         }
+        if (!string_to_pair_states_engine(vm["pair-states-engine"].as<string>(),
+                                          options.pair_states_engine)) {
+            cerr << "Unknown pair-states engine: "
+                 << vm["pair-states-engine"].as<string>() << endl;
+            return false;
+        }
 
-        if (options.algorithm != Algorithm::AUTOMATON &&
+        if (options.algorithm == Algorithm::FORMULA &&
             options.find_input_dependencies) {
-            cerr << "Input dependencies can only be found using the automaton "
-                    "algorithm"
+            cerr << "Input dependencies can only be found using the automaton or sat "
+                    "algorithms"
                  << endl;
             return false;
         }
@@ -172,6 +295,8 @@ Algorithm string_to_algorithm(const std::string &str) {
         return Algorithm::FORMULA;
     } else if (str == "automaton") {
         return Algorithm::AUTOMATON;
+    } else if (str == "sat") {
+        return Algorithm::SAT;
     } else {
         return Algorithm::UNKNOWN;
     }
@@ -183,6 +308,90 @@ std::string algorithm_to_string(const Algorithm &algo) {
             return "formula";
         case Algorithm::AUTOMATON:
             return "automaton";
+        case Algorithm::SAT:
+            return "sat";
+        default:
+            return "unknown";
+    }
+}
+
+bool string_to_pair_states_engine(const std::string &str, PairStatesEngine &engine) {
+    if (str == "auto") {
+        engine = PairStatesEngine::AUTO_ENGINE;
+    } else if (str == "explicit") {
+        engine = PairStatesEngine::EXPLICIT_ENGINE;
+    } else if (str == "symbolic") {
+        engine = PairStatesEngine::SYMBOLIC_ENGINE;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string pair_states_engine_to_string(const PairStatesEngine &engine) {
+    switch (engine) {
+        case PairStatesEngine::EXPLICIT_ENGINE:
+            return "explicit";
+        case PairStatesEngine::SYMBOLIC_ENGINE:
+            return "symbolic";
+        default:
+            return "auto";
+    }
+}
+
+bool string_to_state_encoding(const std::string &str, StateEncoding &encoding) {
+    if (str == "onehot") {
+        encoding = StateEncoding::ONE_HOT_ENCODING;
+    } else if (str == "binary") {
+        encoding = StateEncoding::BINARY_ENCODING;
+    } else if (str == "gray") {
+        encoding = StateEncoding::GRAY_ENCODING;
+    } else if (str == "smallest") {
+        encoding = StateEncoding::SMALLEST_ENCODING;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string state_encoding_to_string(const StateEncoding &encoding) {
+    switch (encoding) {
+        case StateEncoding::BINARY_ENCODING:
+            return "binary";
+        case StateEncoding::GRAY_ENCODING:
+            return "gray";
+        case StateEncoding::SMALLEST_ENCODING:
+            return "smallest";
+        default:
+            return "onehot";
+    }
+}
+
+bool string_to_synthesis_algo(const std::string &str, spot::synthesis_info::algo &algo) {
+    if (str == "sd") {
+        algo = spot::synthesis_info::algo::SPLIT_DET;
+    } else if (str == "ds") {
+        algo = spot::synthesis_info::algo::DET_SPLIT;
+    } else if (str == "lar") {
+        algo = spot::synthesis_info::algo::LAR;
+    } else if (str == "acd") {
+        algo = spot::synthesis_info::algo::ACD;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+std::string synthesis_algo_to_string(const spot::synthesis_info::algo &algo) {
+    switch (algo) {
+        case spot::synthesis_info::algo::SPLIT_DET:
+            return "sd";
+        case spot::synthesis_info::algo::DET_SPLIT:
+            return "ds";
+        case spot::synthesis_info::algo::LAR:
+            return "lar";
+        case spot::synthesis_info::algo::ACD:
+            return "acd";
         default:
             return "unknown";
     }
@@ -213,6 +422,12 @@ std::ostream &operator<<(std::ostream &out,
     out << " - Algorithm: " << algorithm_to_string(options.algorithm) << endl;
     out << " - Type of dependent variables: "
         << (options.find_input_dependencies ? "input" : "output") << endl;
+    out << " - Pair-states workers: " << options.pair_states_workers << endl;
+    out << " - Pair-states engine: "
+        << pair_states_engine_to_string(options.pair_states_engine) << endl;
+    out << " - Dependency workers: " << options.dependency_workers << endl;
+    out << " - Interleave prime vars: " << options.interleave_prime_vars << endl;
+    out << " - NBA cache directory: " << options.nba_cache_dir << endl;
 
     return out;
 }
@@ -227,6 +442,24 @@ std::ostream &operator<<(std::ostream &out, const SynthesisCLIOptions &options)
         << (options.dependency_timeout <= 0) << endl;
     out << " - Find dependency dependencies timeout: "
         << options.dependency_timeout << endl;
+    out << " - Pair-states workers: " << options.pair_states_workers << endl;
+    out << " - Pair-states engine: "
+        << pair_states_engine_to_string(options.pair_states_engine) << endl;
+    out << " - SAT dependencies: " << options.sat_dependencies << endl;
+    out << " - Dependency workers: " << options.dependency_workers << endl;
+    out << " - Interleave prime vars: " << options.interleave_prime_vars << endl;
+    out << " - NBA cache directory: " << options.nba_cache_dir << endl;
+    out << " - Synthesis algorithm: " << synthesis_algo_to_string(options.synthesis_algo)
+        << endl;
+    out << " - Portfolio: " << options.portfolio << endl;
+    out << " - Fork dependents synthesis: " << options.fork_dependents_synthesis << endl;
+    out << " - State encoding: " << state_encoding_to_string(options.state_encoding)
+        << endl;
+    out << " - ABC script: " << options.abc_script << endl;
+    out << " - ABC time budget: " << options.abc_time_budget << endl;
+    out << " - Batch file: " << options.batch_path << endl;
+    out << " - Specification timeout: " << options.spec_timeout << endl;
+    out << " - Specification memory limit: " << options.spec_memory_limit << endl;
 
     return out;
 }
@@ -13,21 +13,45 @@
 #include <spot/tl/parse.hh>
 #include <spot/twa/fwd.hh>
 #include <spot/twaalgos/postproc.hh>
+#include <spot/twaalgos/synthesis.hh>
 #include <spot/twaalgos/translate.hh>
 #include <string>
 #include <vector>
 
-enum Algorithm { UNKNOWN = 0, FORMULA = 1, AUTOMATON = 2 };
+enum Algorithm { UNKNOWN = 0, FORMULA = 1, AUTOMATON = 2, SAT = 3 };
 
 Algorithm string_to_algorithm(const std::string &str);
 std::string algorithm_to_string(const Algorithm &algo);
 
+// How the pair-states of the automaton are computed, AUTO picks by automaton size
+enum PairStatesEngine { AUTO_ENGINE = 0, EXPLICIT_ENGINE = 1, SYMBOLIC_ENGINE = 2 };
+
+bool string_to_pair_states_engine(const std::string &str, PairStatesEngine &engine);
+std::string pair_states_engine_to_string(const PairStatesEngine &engine);
+
+// How the dependent strategy encodes the states of the NBA by latches, SMALLEST_ENCODING
+// keeps the encoding with the fewest gates
+enum StateEncoding {
+    ONE_HOT_ENCODING = 0,
+    BINARY_ENCODING = 1,
+    GRAY_ENCODING = 2,
+    SMALLEST_ENCODING = 3
+};
+
+bool string_to_state_encoding(const std::string &str, StateEncoding &encoding);
+std::string state_encoding_to_string(const StateEncoding &encoding);
+
+// The game algorithms of the synthesis: sd, ds, lar, acd (as ltlsynt's --algo)
+bool string_to_synthesis_algo(const std::string &str, spot::synthesis_info::algo &algo);
+std::string synthesis_algo_to_string(const spot::synthesis_info::algo &algo);
+
 struct BaseCLIOptions {
     std::string formula;
     std::string inputs;
     std::string outputs;
     bool verbose;
     std::string measures_path;
+    bool append_measures{};  // Set by batch runs, which write a record per specification
 };
 
 struct SynthesisCLIOptions : public BaseCLIOptions {
@@ -36,7 +60,22 @@ struct SynthesisCLIOptions : public BaseCLIOptions {
     bool merge_strategies;
     bool apply_model_checking;
     bool measure_bdd;
+    unsigned pair_states_workers;
+    PairStatesEngine pair_states_engine;
+    bool sat_dependencies;
+    unsigned dependency_workers;
+    bool interleave_prime_vars;
+    std::string nba_cache_dir;
+    bool fork_dependents_synthesis;
+    StateEncoding state_encoding;
+    spot::synthesis_info::algo synthesis_algo;
+    bool portfolio;
+    std::string abc_script;
+    int abc_time_budget;
     std::string model_name;
+    std::string batch_path;
+    int spec_timeout;
+    unsigned spec_memory_limit;
 };
 
 struct FindUnatesCLIOptions : public BaseCLIOptions {
@@ -45,6 +84,11 @@ struct FindUnatesCLIOptions : public BaseCLIOptions {
 struct FindDependenciesCLIOptions : public BaseCLIOptions {
     Algorithm algorithm{UNKNOWN};
     bool find_input_dependencies{};
+    unsigned pair_states_workers{};
+    PairStatesEngine pair_states_engine{AUTO_ENGINE};
+    unsigned dependency_workers{};
+    bool interleave_prime_vars{};
+    std::string nba_cache_dir;
 };
 
 struct pair_hash {
@@ -53,7 +97,8 @@ struct pair_hash {
         auto h1 = std::hash<T1>{}(p.first);
         auto h2 = std::hash<T2>{}(p.second);
 
-        return h1 ^ h2;
+        // Same as boost::hash_combine, a plain XOR maps (a,b) and (b,a) to the same hash
+        return h1 ^ (h2 + 0x9e3779b9 + (h1 << 6) + (h1 >> 2));
     }
 };
 
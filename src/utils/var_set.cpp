@@ -0,0 +1,22 @@
+#include "var_set.h"
+
+size_t VarSet::size() const {
+    size_t total = 0;
+    for (uint64_t word : m_words) {
+        total += __builtin_popcountll(word);
+    }
+    return total;
+}
+
+VarSet VarSet::complement() const {
+    VarSet result(m_total_vars);
+    for (size_t word_idx = 0; word_idx < m_words.size(); word_idx++) {
+        result.m_words[word_idx] = ~m_words[word_idx];
+    }
+
+    // Clear the bits beyond the last variable
+    if (m_total_vars % 64 != 0) {
+        result.m_words.back() &= (1ull << (m_total_vars % 64)) - 1;
+    }
+    return result;
+}
@@ -0,0 +1,50 @@
+#ifndef VAR_SET_H
+#define VAR_SET_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Dense id of a variable in a SyntInstance, inputs come first and then outputs
+using VarId = unsigned;
+
+/**
+ * @brief Set of variables of a SyntInstance, stored as a bitset over their ids.
+ */
+class VarSet {
+   private:
+    std::vector<uint64_t> m_words;
+    size_t m_total_vars;
+
+   public:
+    explicit VarSet(size_t total_vars = 0)
+        : m_words((total_vars + 63) / 64, 0), m_total_vars(total_vars) {}
+
+    void insert(VarId id) { m_words[id >> 6] |= 1ull << (id & 63); }
+
+    void erase(VarId id) { m_words[id >> 6] &= ~(1ull << (id & 63)); }
+
+    bool contains(VarId id) const { return (m_words[id >> 6] >> (id & 63)) & 1; }
+
+    // Total variables in the set
+    size_t size() const;
+
+    // Total variables of the instance, i.e. the maximal size of the set
+    size_t total_vars() const { return m_total_vars; }
+
+    // All the variables of the instance which are not in the set
+    VarSet complement() const;
+
+    template <class Func>
+    void for_each(Func func) const {
+        for (size_t word_idx = 0; word_idx < m_words.size(); word_idx++) {
+            uint64_t word = m_words[word_idx];
+            while (word != 0) {
+                func(static_cast<VarId>(word_idx * 64 + __builtin_ctzll(word)));
+                word &= word - 1;
+            }
+        }
+    }
+};
+
+#endif
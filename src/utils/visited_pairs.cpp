@@ -0,0 +1,126 @@
+#include "visited_pairs.h"
+
+#include <utility>
+
+#define VISITED_PAIRS_INITIAL_TABLE_SIZE 1024
+
+static inline uint64_t triangular_index(unsigned p, unsigned q) {
+    // Assumes p <= q
+    return static_cast<uint64_t>(q) * (q + 1) / 2 + p;
+}
+
+// splitmix64 finalizer, unlike std::hash<int> it spreads neighbour keys
+static inline uint64_t mix_key(uint64_t key) {
+    key ^= key >> 30;
+    key *= 0xbf58476d1ce4e5b9ull;
+    key ^= key >> 27;
+    key *= 0x94d049bb133111ebull;
+    key ^= key >> 31;
+    return key;
+}
+
+VisitedPairs::VisitedPairs(unsigned total_states, uint64_t max_bitmap_bits)
+    : m_table_mask(0), m_total_pairs(0) {
+    uint64_t total_bits = triangular_index(0, total_states);
+
+    if (total_bits <= max_bitmap_bits) {
+        m_structure = Structure::TriangularBitmap;
+        m_bitmap.assign((total_bits + 63) / 64, 0);
+    } else {
+        m_structure = Structure::HashTable;
+        m_table.assign(VISITED_PAIRS_INITIAL_TABLE_SIZE, EMPTY_KEY);
+        m_table_mask = VISITED_PAIRS_INITIAL_TABLE_SIZE - 1;
+    }
+}
+
+bool VisitedPairs::insert(unsigned p, unsigned q) {
+    if (p > q) {
+        std::swap(p, q);
+    }
+
+    if (m_structure == Structure::TriangularBitmap) {
+        uint64_t idx = triangular_index(p, q);
+        uint64_t bit = 1ull << (idx & 63);
+        uint64_t& word = m_bitmap[idx >> 6];
+
+        if (word & bit) {
+            return false;
+        }
+        word |= bit;
+        m_total_pairs++;
+        return true;
+    }
+
+    // Keep the load factor below 1/2
+    if (2 * (m_total_pairs + 1) > m_table.size()) {
+        grow_table();
+    }
+
+    uint64_t key = (static_cast<uint64_t>(p) << 32) | q;
+    if (!insert_to_table(key)) {
+        return false;
+    }
+    m_total_pairs++;
+    return true;
+}
+
+bool VisitedPairs::contains(unsigned p, unsigned q) const {
+    if (p > q) {
+        std::swap(p, q);
+    }
+
+    if (m_structure == Structure::TriangularBitmap) {
+        uint64_t idx = triangular_index(p, q);
+        return (m_bitmap[idx >> 6] >> (idx & 63)) & 1;
+    }
+
+    uint64_t key = (static_cast<uint64_t>(p) << 32) | q;
+    for (size_t slot = mix_key(key) & m_table_mask;; slot = (slot + 1) & m_table_mask) {
+        if (m_table[slot] == key) {
+            return true;
+        }
+        if (m_table[slot] == EMPTY_KEY) {
+            return false;
+        }
+    }
+}
+
+bool VisitedPairs::insert_to_table(uint64_t key) {
+    for (size_t slot = mix_key(key) & m_table_mask;; slot = (slot + 1) & m_table_mask) {
+        if (m_table[slot] == key) {
+            return false;
+        }
+        if (m_table[slot] == EMPTY_KEY) {
+            m_table[slot] = key;
+            return true;
+        }
+    }
+}
+
+void VisitedPairs::grow_table() {
+    std::vector<uint64_t> old_table(m_table.size() * 2, EMPTY_KEY);
+    old_table.swap(m_table);
+    m_table_mask = m_table.size() - 1;
+
+    for (uint64_t key : old_table) {
+        if (key != EMPTY_KEY) {
+            insert_to_table(key);
+        }
+    }
+}
+
+size_t VisitedPairs::memory_usage() const {
+    return m_bitmap.capacity() * sizeof(uint64_t) +
+           m_table.capacity() * sizeof(uint64_t);
+}
+
+const char* visited_pairs_structure_to_string(VisitedPairs::Structure structure) {
+    switch (structure) {
+        case VisitedPairs::Structure::TriangularBitmap:
+            return "triangular_bitmap";
+        case VisitedPairs::Structure::HashTable:
+            return "hash_table";
+        default:
+            return "unknown";
+    }
+}
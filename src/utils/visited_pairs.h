@@ -0,0 +1,61 @@
+#ifndef VISITED_PAIRS_H
+#define VISITED_PAIRS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// Above this number of bits, the triangular bitmap is replaced by a hash table
+#define VISITED_PAIRS_MAX_BITMAP_BITS (1ull << 28)
+
+/**
+ * @brief Set of unordered pairs of states (p,q), used to mark the visited pair-states.
+ *
+ * For small automata the set is a triangular bit matrix, i.e. a single bit for each
+ * pair p <= q. If the matrix is too large, an open-addressing hash table (linear
+ * probing) of 64-bit keys is used instead.
+ */
+class VisitedPairs {
+   public:
+    enum Structure { TriangularBitmap, HashTable };
+
+   private:
+    Structure m_structure;
+
+    // Triangular bitmap
+    std::vector<uint64_t> m_bitmap;
+
+    // Hash table, empty slots are marked by EMPTY_KEY
+    std::vector<uint64_t> m_table;
+    size_t m_table_mask;
+    size_t m_total_pairs;
+
+    static constexpr uint64_t EMPTY_KEY = ~0ull;
+
+    bool insert_to_table(uint64_t key);
+
+    void grow_table();
+
+   public:
+    explicit VisitedPairs(unsigned total_states,
+                          uint64_t max_bitmap_bits = VISITED_PAIRS_MAX_BITMAP_BITS);
+
+    /**
+     * @brief Add the pair (p,q) to the set, the order of p and q is not important.
+     * Return true if the pair was not in the set before.
+     */
+    bool insert(unsigned p, unsigned q);
+
+    bool contains(unsigned p, unsigned q) const;
+
+    size_t size() const { return m_total_pairs; }
+
+    Structure structure() const { return m_structure; }
+
+    // Total bytes allocated by the set
+    size_t memory_usage() const;
+};
+
+const char* visited_pairs_structure_to_string(VisitedPairs::Structure structure);
+
+#endif